@@ -0,0 +1,278 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Benchmark the EDS generated topic converters
+**
+** Notes:
+**   1. Built when the CMake option JMSG_APP_TOPIC_CONV_BENCH is ON.
+**      Usage: jmsg_app_topic_conv_bench [iterations]
+**   2. The topic plugins' own converters are in JMSG_LIB and need cFE so
+**      they can't be linked here. Their JSON-to-SB conversion loads a CJSON
+**      object table with one core-json search per field. The generated
+**      FromJson functions are compared with a converter that does the same
+**      searches with the same core-json source. The topic plugins' SB-to-JSON
+**      conversion is a single format string like the generated ToJson
+**      functions, so ToJson is only timed.
+**   3. The keyed converter only supports flat containers so containers with
+**      nested containers or arrays only report the generated times.
+**   4. Payloads are round tripped through both FromJson paths and compared
+**      with the original to check the generated converters.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cjson.h"
+#include "topic_conv_gen.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define DEF_ITERATIONS  100000
+#define JSON_BUF_LEN    4096
+#define NUM_STR_MAX_LEN 32
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static double ElapsedNsec(const struct timespec *Start);
+static bool   KeyedFromJson(const TOPIC_CONV_BenchField_t *Fields, const char *Json, size_t JsonLen, void *Payload);
+static void   RunConv(const TOPIC_CONV_Conv_t *Conv, const TOPIC_CONV_BenchField_t *Fields,
+                      void *Payload, void *GenPayload, void *KeyedPayload, long Iterations);
+static void   SetField(const TOPIC_CONV_BenchField_t *Field, void *Payload, long long IntValue, double DblValue);
+
+
+/******************************************************************************
+** Function: main
+**
+*/
+int main(int argc, char *argv[])
+{
+
+   long   Iterations = (argc > 1) ? strtol(argv[1], NULL, 10) : DEF_ITERATIONS;
+   void  *Payload;
+   void  *GenPayload;
+   void  *KeyedPayload;
+   const TOPIC_CONV_Conv_t *Conv;
+   const TOPIC_CONV_BenchField_t *Fields;
+
+   if (Iterations <= 0)
+   {
+      Iterations = DEF_ITERATIONS;
+   }
+
+   printf("%ld iterations, nanoseconds per conversion\n", Iterations);
+   printf("%-40s %12s %12s %14s\n", "Container", "Gen ToJson", "Gen FromJson", "CJSON FromJson");
+
+   for (int c=0; TOPIC_CONV_ConvTbl[c].Name != NULL; c++)
+   {
+
+      Conv   = &TOPIC_CONV_ConvTbl[c];
+      Fields = TOPIC_CONV_BenchTbl[c].Fields;
+
+      Payload      = calloc(1, Conv->PayloadSize);
+      GenPayload   = calloc(1, Conv->PayloadSize);
+      KeyedPayload = calloc(1, Conv->PayloadSize);
+
+      if (Payload == NULL || GenPayload == NULL || KeyedPayload == NULL)
+      {
+         printf("%-40s Payload allocation failed\n", Conv->Name);
+      }
+      else
+      {
+         RunConv(Conv, Fields, Payload, GenPayload, KeyedPayload, Iterations);
+      }
+
+      free(Payload);
+      free(GenPayload);
+      free(KeyedPayload);
+
+   } /* End converter loop */
+
+   return 0;
+
+} /* End main() */
+
+
+/******************************************************************************
+** Function: ElapsedNsec
+**
+*/
+static double ElapsedNsec(const struct timespec *Start)
+{
+
+   struct timespec End;
+
+   clock_gettime(CLOCK_MONOTONIC, &End);
+
+   return (End.tv_sec - Start->tv_sec) * 1.0e9 + (End.tv_nsec - Start->tv_nsec);
+
+} /* End ElapsedNsec() */
+
+
+/******************************************************************************
+** Function: KeyedFromJson
+**
+*/
+static bool KeyedFromJson(const TOPIC_CONV_BenchField_t *Fields, const char *Json, size_t JsonLen, void *Payload)
+{
+
+   char  NumStr[NUM_STR_MAX_LEN];
+   char *Value;
+   size_t ValueLen;
+   JSONTypes_t ValueType;
+
+   for (const TOPIC_CONV_BenchField_t *Field = Fields; Field->Name != NULL; Field++)
+   {
+
+      if (JSON_SearchT((char *)Json, JsonLen, Field->Name, strlen(Field->Name),
+                       &Value, &ValueLen, &ValueType) != JSONSuccess)
+      {
+         return false;
+      }
+
+      if (Field->Kind == TOPIC_CONV_BENCH_STRING)
+      {
+         if (ValueLen >= Field->Size)
+         {
+            return false;
+         }
+         memcpy((uint8 *)Payload + Field->Offset, Value, ValueLen);
+         ((char *)Payload)[Field->Offset + ValueLen] = '\0';
+      }
+      else
+      {
+         if (ValueLen >= sizeof(NumStr))
+         {
+            return false;
+         }
+         memcpy(NumStr, Value, ValueLen);
+         NumStr[ValueLen] = '\0';
+         SetField(Field, Payload, strtoll(NumStr, NULL, 10), strtod(NumStr, NULL));
+      }
+
+   } /* End field loop */
+
+   return true;
+
+} /* End KeyedFromJson() */
+
+
+/******************************************************************************
+** Function: RunConv
+**
+*/
+static void RunConv(const TOPIC_CONV_Conv_t *Conv, const TOPIC_CONV_BenchField_t *Fields,
+                    void *Payload, void *GenPayload, void *KeyedPayload, long Iterations)
+{
+
+   char   GenJson[JSON_BUF_LEN];
+   size_t GenJsonLen;
+   double GenToJsonNs, GenFromJsonNs;
+   double KeyedFromJsonNs;
+   struct timespec Start;
+
+   for (int f=0; Fields != NULL && Fields[f].Name != NULL; f++)
+   {
+      SetField(&Fields[f], Payload, f + 1, (f + 1) * 1.25);
+   }
+
+   GenJsonLen = Conv->ToJson(Payload, GenJson, sizeof(GenJson));
+   if (GenJsonLen == 0)
+   {
+      printf("%-40s ToJson failed\n", Conv->Name);
+      return;
+   }
+
+   clock_gettime(CLOCK_MONOTONIC, &Start);
+   for (long i=0; i < Iterations; i++)
+   {
+      Conv->ToJson(Payload, GenJson, sizeof(GenJson));
+   }
+   GenToJsonNs = ElapsedNsec(&Start) / Iterations;
+
+   clock_gettime(CLOCK_MONOTONIC, &Start);
+   for (long i=0; i < Iterations; i++)
+   {
+      Conv->FromJson(GenJson, GenJsonLen, GenPayload);
+   }
+   GenFromJsonNs = ElapsedNsec(&Start) / Iterations;
+
+   if (Fields != NULL)
+   {
+
+      clock_gettime(CLOCK_MONOTONIC, &Start);
+      for (long i=0; i < Iterations; i++)
+      {
+         KeyedFromJson(Fields, GenJson, GenJsonLen, KeyedPayload);
+      }
+      KeyedFromJsonNs = ElapsedNsec(&Start) / Iterations;
+
+      printf("%-40s %12.1f %12.1f %14.1f%s\n", Conv->Name,
+             GenToJsonNs, GenFromJsonNs, KeyedFromJsonNs,
+             (memcmp(Payload, GenPayload, Conv->PayloadSize) == 0 &&
+              memcmp(Payload, KeyedPayload, Conv->PayloadSize) == 0) ? "" : "  MISMATCH");
+   }
+   else
+   {
+      printf("%-40s %12.1f %12.1f %14s%s\n", Conv->Name, GenToJsonNs, GenFromJsonNs, "-",
+             (memcmp(Payload, GenPayload, Conv->PayloadSize) == 0) ? "" : "  MISMATCH");
+   }
+
+} /* End RunConv() */
+
+
+/******************************************************************************
+** Function: SetField
+**
+** Write a value to a payload field using its descriptor. Integers are
+** written in host byte order and are truncated to the field size.
+*/
+static void SetField(const TOPIC_CONV_BenchField_t *Field, void *Payload, long long IntValue, double DblValue)
+{
+
+   uint8 *FieldPtr = (uint8 *)Payload + Field->Offset;
+   float  Flt;
+   uint8  Bytes[sizeof(long long)];
+
+   switch (Field->Kind)
+   {
+      case TOPIC_CONV_BENCH_FLOAT:
+         Flt = (float)DblValue;
+         memcpy(FieldPtr, &Flt, sizeof(Flt));
+         break;
+      case TOPIC_CONV_BENCH_DOUBLE:
+         memcpy(FieldPtr, &DblValue, sizeof(DblValue));
+         break;
+      case TOPIC_CONV_BENCH_STRING:
+         snprintf((char *)FieldPtr, Field->Size, "bench%lld", IntValue);
+         break;
+      default:
+         memcpy(Bytes, &IntValue, sizeof(Bytes));
+         memcpy(FieldPtr, Bytes, (Field->Size < sizeof(Bytes)) ? Field->Size : sizeof(Bytes));
+         break;
+   }
+
+} /* End SetField() */
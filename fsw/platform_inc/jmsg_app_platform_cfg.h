@@ -36,5 +36,48 @@
 #define JMSG_APP_PLATFORM_REV   0
 #define JMSG_APP_INI_FILENAME   "/cf/jmsg_app_ini.json"
 
+/*
+** Each JMSG_APP instance reads the ini file named after its lower case cFE
+** app name. JMSG_APP_INI_FILENAME is used if the app name can't be read.
+*/
+#define JMSG_APP_INI_FILENAME_FMT  "/cf/%s_ini.json"
+
+/*
+** Maximum length of the loopback test's multi-topic JSON frame including the
+** null terminator. Also sizes the loopback test's datagram buffers.
+*/
+#define JMSG_APP_AGG_FRAME_MAX_LEN  4096
+
+/*
+** Size of the JSON buffer of each generated topic converter that is
+** assigned to a topic plugin. See topic_conv.h.
+*/
+#define JMSG_APP_TOPIC_CONV_JSON_MAX_LEN  1024
+
+/*
+** Size of each hooked topic plugin's COMPACT_JSON message buffer including
+** the null terminator. Longer messages are sent without being compacted.
+** See topic_hook.h.
+*/
+#define JMSG_APP_TOPIC_COMPACT_JSON_MAX_LEN  1024
+
+/*
+** Number of loopback test round trip samples kept between LoopbackTestTlm
+** packets. The oldest samples are replaced when more round trips complete.
+*/
+#define JMSG_APP_LOOPBACK_SAMPLE_CNT  512
+
+/*
+** Number of message ID index slots. Must be a power of 2 and should be at
+** least twice the number of topic plugins owned by the instance.
+*/
+#define JMSG_APP_MID_INDEX_SIZE  512
+
+/*
+** Maximum topic name length in the topic name index including the null
+** terminator. Longer topic names are reported and aren't indexed.
+*/
+#define JMSG_APP_TOPIC_NAME_MAX_LEN  64
+
 
 #endif /* _jmsg_app_platform_cfg_ */
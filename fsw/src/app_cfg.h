@@ -48,6 +48,14 @@
 #define  JMSG_APP_MINOR_VER      0
 
 
+/*
+** Number of topic plugins defined by the JMSG_PLATFORM/TopicPlugin EDS
+** enumeration. Used to size JMSG_APP's per-topic data. 
+*/
+
+#define  JMSG_APP_TOPIC_PLUGIN_CNT  (JMSG_PLATFORM_TopicPlugin_Enum_t_MAX - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN + 1)
+
+
 /******************************************************************************
 ** Init File declarations create:
 **
@@ -75,13 +83,42 @@
 #define CFG_JMSG_LIB_TOPIC_TBL_TLM_TOPICID        JMSG_LIB_TOPIC_TBL_TLM_TOPICID
 #define CFG_JMSG_APP_EXECUTE_TLM_TOPICID          BC_SCH_2_SEC_TOPICID
 #define CFG_JMSG_LIB_TOPIC_SUBSCRIBE_TLM_TOPICID  JMSG_LIB_TOPIC_SUBSCRIBE_TLM_TOPICID
+#define CFG_JMSG_APP_PIPE_HEALTH_TLM_TOPICID      JMSG_APP_PIPE_HEALTH_TLM_TOPICID
+#define CFG_JMSG_APP_TOPIC_STATS_TLM_TOPICID      JMSG_APP_TOPIC_STATS_TLM_TOPICID
+#define CFG_JMSG_APP_SCH_TIMING_TLM_TOPICID       JMSG_APP_SCH_TIMING_TLM_TOPICID
+#define CFG_JMSG_APP_TOPIC_ENCODING_TLM_TOPICID   JMSG_APP_TOPIC_ENCODING_TLM_TOPICID
+#define CFG_JMSG_APP_LOOPBACK_TEST_MSG_TOPICID    JMSG_APP_LOOPBACK_TEST_MSG_TOPICID
+#define CFG_JMSG_APP_LOOPBACK_RETURN_MSG_TOPICID  JMSG_APP_LOOPBACK_RETURN_MSG_TOPICID
+#define CFG_JMSG_APP_LOOPBACK_TEST_TLM_TOPICID    JMSG_APP_LOOPBACK_TEST_TLM_TOPICID
    
 #define CFG_CMD_PIPE_NAME   CMD_PIPE_NAME
 #define CFG_CMD_PIPE_DEPTH  CMD_PIPE_DEPTH
 
-#define CFG_TOPIC_SUBSCRIBE_STARTUP_DELAY  TOPIC_SUBSCRIBE_STARTUP_DELAY
-#define CFG_TOPIC_SUBSCRIBE_TLM_DELAY      TOPIC_SUBSCRIBE_TLM_DELAY
-#define CFG_JMSG_TOPIC_TBL_FILE            JMSG_TOPIC_TBL_FILE
+#define CFG_TOPIC_PLUGIN_FIRST  TOPIC_PLUGIN_FIRST
+#define CFG_TOPIC_PLUGIN_LAST   TOPIC_PLUGIN_LAST
+#define CFG_USR_TPLUG_OWNER     USR_TPLUG_OWNER
+
+#define CFG_TOPIC_SUBSCRIBE_STARTUP_DELAY       TOPIC_SUBSCRIBE_STARTUP_DELAY
+#define CFG_TOPIC_SUBSCRIBE_TLM_DELAY           TOPIC_SUBSCRIBE_TLM_DELAY
+#define CFG_TOPIC_SUBSCRIBE_CRITICAL_TLM_DELAY  TOPIC_SUBSCRIBE_CRITICAL_TLM_DELAY
+#define CFG_JMSG_TOPIC_TBL_FILE                 JMSG_TOPIC_TBL_FILE
+#define CFG_TOPIC_ATTR_TBL_FILE                 TOPIC_ATTR_TBL_FILE
+#define CFG_WAKEUP_BUDGET                       WAKEUP_BUDGET
+#define CFG_WAKEUP_WALL_LIMIT                   WAKEUP_WALL_LIMIT
+#define CFG_SCH_EXPECTED_PERIOD                 SCH_EXPECTED_PERIOD
+#define CFG_SCH_PERIOD_TOLERANCE                SCH_PERIOD_TOLERANCE
+#define CFG_SCH_TIMING_TLM_PERIOD               SCH_TIMING_TLM_PERIOD
+#define CFG_LOOPBACK_MSG_PER_CYCLE              LOOPBACK_MSG_PER_CYCLE
+#define CFG_LOOPBACK_ECHO_ADDR                  LOOPBACK_ECHO_ADDR
+#define CFG_LOOPBACK_ECHO_PORT                  LOOPBACK_ECHO_PORT
+#define CFG_LOOPBACK_BRIDGE_PORT                LOOPBACK_BRIDGE_PORT
+#define CFG_LOOPBACK_CHILD_PRIORITY             LOOPBACK_CHILD_PRIORITY
+#define CFG_LOOPBACK_AGG_FRAME_LEN              LOOPBACK_AGG_FRAME_LEN
+#define CFG_LOOPBACK_AGG_FLUSH_PERIOD           LOOPBACK_AGG_FLUSH_PERIOD
+#define CFG_EVT_LIM_BURST                       EVT_LIM_BURST
+#define CFG_EVT_LIM_REFILL_PERIOD               EVT_LIM_REFILL_PERIOD
+#define CFG_EVT_LIM_REPORT_PERIOD               EVT_LIM_REPORT_PERIOD
+#define CFG_CDS_SAVE_PERIOD                     CDS_SAVE_PERIOD
 
 #define APP_CONFIG(XX) \
    XX(APP_CFE_NAME,char*) \
@@ -91,11 +128,39 @@
    XX(JMSG_LIB_TOPIC_TBL_TLM_TOPICID,uint32) \
    XX(BC_SCH_2_SEC_TOPICID,uint32) \
    XX(JMSG_LIB_TOPIC_SUBSCRIBE_TLM_TOPICID,uint32) \
+   XX(JMSG_APP_PIPE_HEALTH_TLM_TOPICID,uint32) \
+   XX(JMSG_APP_TOPIC_STATS_TLM_TOPICID,uint32) \
+   XX(JMSG_APP_SCH_TIMING_TLM_TOPICID,uint32) \
+   XX(JMSG_APP_TOPIC_ENCODING_TLM_TOPICID,uint32) \
+   XX(JMSG_APP_LOOPBACK_TEST_MSG_TOPICID,uint32) \
+   XX(JMSG_APP_LOOPBACK_RETURN_MSG_TOPICID,uint32) \
+   XX(JMSG_APP_LOOPBACK_TEST_TLM_TOPICID,uint32) \
    XX(CMD_PIPE_NAME,char*) \
    XX(CMD_PIPE_DEPTH,uint32) \
+   XX(TOPIC_PLUGIN_FIRST,uint32) \
+   XX(TOPIC_PLUGIN_LAST,uint32) \
+   XX(USR_TPLUG_OWNER,uint32) \
    XX(TOPIC_SUBSCRIBE_STARTUP_DELAY,uint32) \
    XX(TOPIC_SUBSCRIBE_TLM_DELAY,uint32) \
-   XX(JMSG_TOPIC_TBL_FILE,char*)
+   XX(TOPIC_SUBSCRIBE_CRITICAL_TLM_DELAY,uint32) \
+   XX(JMSG_TOPIC_TBL_FILE,char*) \
+   XX(TOPIC_ATTR_TBL_FILE,char*) \
+   XX(WAKEUP_BUDGET,uint32) \
+   XX(WAKEUP_WALL_LIMIT,uint32) \
+   XX(SCH_EXPECTED_PERIOD,uint32) \
+   XX(SCH_PERIOD_TOLERANCE,uint32) \
+   XX(SCH_TIMING_TLM_PERIOD,uint32) \
+   XX(LOOPBACK_MSG_PER_CYCLE,uint32) \
+   XX(LOOPBACK_ECHO_ADDR,char*) \
+   XX(LOOPBACK_ECHO_PORT,uint32) \
+   XX(LOOPBACK_BRIDGE_PORT,uint32) \
+   XX(LOOPBACK_CHILD_PRIORITY,uint32) \
+   XX(LOOPBACK_AGG_FRAME_LEN,uint32) \
+   XX(LOOPBACK_AGG_FLUSH_PERIOD,uint32) \
+   XX(EVT_LIM_BURST,uint32) \
+   XX(EVT_LIM_REFILL_PERIOD,uint32) \
+   XX(EVT_LIM_REPORT_PERIOD,uint32) \
+   XX(CDS_SAVE_PERIOD,uint32)
    
 
 DECLARE_ENUM(Config,APP_CONFIG)
@@ -109,7 +174,18 @@ DECLARE_ENUM(Config,APP_CONFIG)
 ** exceeded so it is the developer's responsibility to verify the ranges. 
 */
 
-#define JMSG_APP_BASE_EID      (APP_C_FW_APP_BASE_EID +  0)
-#define JMSG_LIB_MGR_BASE_EID  (APP_C_FW_APP_BASE_EID + 20)
+#define JMSG_APP_BASE_EID        (APP_C_FW_APP_BASE_EID +  0)
+#define JMSG_LIB_MGR_BASE_EID    (APP_C_FW_APP_BASE_EID + 20)
+#define TOPIC_ATTR_TBL_BASE_EID  (APP_C_FW_APP_BASE_EID + 40)
+#define TOPIC_FWD_BASE_EID       (APP_C_FW_APP_BASE_EID + 60)
+#define FRAME_AGG_BASE_EID       (APP_C_FW_APP_BASE_EID + 80)
+#define LOOPBACK_TEST_BASE_EID   (APP_C_FW_APP_BASE_EID + 100)
+#define WAKEUP_BUDGET_BASE_EID   (APP_C_FW_APP_BASE_EID + 120)
+#define TOPIC_PART_BASE_EID      (APP_C_FW_APP_BASE_EID + 140)
+#define TOPIC_IDX_BASE_EID       (APP_C_FW_APP_BASE_EID + 160)
+#define EVT_LIM_BASE_EID         (APP_C_FW_APP_BASE_EID + 180)
+#define TOPIC_CDS_BASE_EID       (APP_C_FW_APP_BASE_EID + 200)
+#define TOPIC_HOOK_BASE_EID      (APP_C_FW_APP_BASE_EID + 220)
+#define JMSG_APP_END_EID         (APP_C_FW_APP_BASE_EID + 240)  /* One past the last object's range */
 
 #endif /* _app_cfg_ */
@@ -0,0 +1,296 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the EVT_LIM class
+**
+** Notes:
+**   None
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "evt_lim.h"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void AdaptBucket(EVT_LIM_Bucket_t *Bucket);
+static void InitBuckets(void);
+static void RefillBucket(EVT_LIM_Bucket_t *Bucket);
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static EVT_LIM_Class_t *EvtLim;
+
+
+/******************************************************************************
+** Function: EVT_LIM_Constructor
+**
+*/
+void EVT_LIM_Constructor(EVT_LIM_Class_t *EvtLimPtr, const INITBL_Class_t *IniTbl)
+{
+
+   EvtLim = EvtLimPtr;
+
+   memset((void*)EvtLim, 0, sizeof(EVT_LIM_Class_t));
+
+   EvtLim->Burst        = INITBL_GetIntConfig(IniTbl, CFG_EVT_LIM_BURST);
+   EvtLim->RefillPeriod = INITBL_GetIntConfig(IniTbl, CFG_EVT_LIM_REFILL_PERIOD);
+   EvtLim->ReportPeriod = INITBL_GetIntConfig(IniTbl, CFG_EVT_LIM_REPORT_PERIOD);
+
+   if (EvtLim->RefillPeriod == 0)
+   {
+      EvtLim->RefillPeriod = 1;
+   }
+   if (EvtLim->ReportPeriod == 0)
+   {
+      EvtLim->ReportPeriod = 1;
+   }
+
+   InitBuckets();
+
+} /* End EVT_LIM_Constructor() */
+
+
+/******************************************************************************
+** Function: EVT_LIM_GetSuppressedCnt
+**
+*/
+uint32 EVT_LIM_GetSuppressedCnt(void)
+{
+
+   return EvtLim->SuppressedCnt;
+
+} /* End EVT_LIM_GetSuppressedCnt() */
+
+
+/******************************************************************************
+** Function: EVT_LIM_ResetStatus
+**
+*/
+void EVT_LIM_ResetStatus(void)
+{
+
+   EvtLim->SuppressedCnt = 0;
+   InitBuckets();
+
+} /* End EVT_LIM_ResetStatus() */
+
+
+/******************************************************************************
+** Function: EVT_LIM_Run
+**
+*/
+void EVT_LIM_Run(void)
+{
+
+   uint32 SuppressedCnt = 0;
+   uint16 MaxEid = 0;
+   uint32 MaxEidCnt = 0;
+   int32  MaxTopic = EVT_LIM_NO_TOPIC;
+   uint32 MaxTopicCnt = 0;
+
+   EvtLim->WakeupCnt++;
+
+   if ((EvtLim->WakeupCnt % EvtLim->ReportPeriod) != 0)
+   {
+      return;
+   }
+
+   for (uint16 i=0; i < EVT_LIM_EID_CNT; i++)
+   {
+      if (EvtLim->Eid[i].SuppressedCnt > MaxEidCnt)
+      {
+         MaxEid    = JMSG_APP_BASE_EID + i;
+         MaxEidCnt = EvtLim->Eid[i].SuppressedCnt;
+      }
+      SuppressedCnt += EvtLim->Eid[i].SuppressedCnt;
+      AdaptBucket(&EvtLim->Eid[i]);
+   }
+
+   for (uint32 i=0; i < JMSG_APP_TOPIC_PLUGIN_CNT; i++)
+   {
+      if (EvtLim->Topic[i].SuppressedCnt > MaxTopicCnt)
+      {
+         MaxTopic    = JMSG_PLATFORM_TopicPlugin_Enum_t_MIN + i;
+         MaxTopicCnt = EvtLim->Topic[i].SuppressedCnt;
+      }
+      SuppressedCnt += EvtLim->Topic[i].SuppressedCnt;
+      AdaptBucket(&EvtLim->Topic[i]);
+   }
+
+   if (SuppressedCnt > 0)
+   {
+      CFE_EVS_SendEvent(EVT_LIM_REPORT_EID, CFE_EVS_EventType_INFORMATION,
+                        "Suppressed %u events in the last %u wakeups. Most by event ID %u (%u) and topic plugin %d (%u)",
+                        (unsigned int)SuppressedCnt, EvtLim->ReportPeriod, MaxEid, (unsigned int)MaxEidCnt,
+                        (int)MaxTopic, (unsigned int)MaxTopicCnt);
+   }
+
+} /* End EVT_LIM_Run() */
+
+
+/******************************************************************************
+** Function: EVT_LIM_SendEvent
+**
+*/
+bool EVT_LIM_SendEvent(uint16 EventId, int32 TopicPlugin, uint16 EventType, const char *Spec, ...)
+{
+
+   char    Message[CFE_MISSION_EVS_MAX_MESSAGE_LENGTH];
+   va_list Args;
+   EVT_LIM_Bucket_t *EidBucket   = NULL;
+   EVT_LIM_Bucket_t *TopicBucket = NULL;
+   bool Send = true;
+
+   if (EventType == CFE_EVS_EventType_ERROR &&
+       EventId >= JMSG_APP_BASE_EID && EventId < (JMSG_APP_BASE_EID + EVT_LIM_EID_CNT))
+   {
+      EidBucket = &EvtLim->Eid[EventId - JMSG_APP_BASE_EID];
+      RefillBucket(EidBucket);
+      if (TopicPlugin >= JMSG_PLATFORM_TopicPlugin_Enum_t_MIN && TopicPlugin <= JMSG_PLATFORM_TopicPlugin_Enum_t_MAX)
+      {
+         TopicBucket = &EvtLim->Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+         RefillBucket(TopicBucket);
+      }
+   }
+
+   if (TopicBucket != NULL && TopicBucket->Tokens == 0)
+   {
+      TopicBucket->SuppressedCnt++;
+      Send = false;
+   }
+   else if (EidBucket != NULL && EidBucket->Tokens == 0)
+   {
+      EidBucket->SuppressedCnt++;
+      Send = false;
+   }
+
+   if (Send)
+   {
+      if (EidBucket != NULL)
+      {
+         EidBucket->Tokens--;
+      }
+      if (TopicBucket != NULL)
+      {
+         TopicBucket->Tokens--;
+      }
+
+      va_start(Args, Spec);
+      vsnprintf(Message, sizeof(Message), Spec, Args);
+      va_end(Args);
+
+      CFE_EVS_SendEvent(EventId, EventType, "%s", Message);
+   }
+   else
+   {
+      EvtLim->SuppressedCnt++;
+   }
+
+   return Send;
+
+} /* End EVT_LIM_SendEvent() */
+
+
+/******************************************************************************
+** Function: AdaptBucket
+**
+** Back off a bucket's refill period if it suppressed events during the
+** last report period, otherwise move it back toward the configured period.
+**
+*/
+static void AdaptBucket(EVT_LIM_Bucket_t *Bucket)
+{
+
+   RefillBucket(Bucket);
+
+   if (Bucket->SuppressedCnt > 0)
+   {
+      if (Bucket->RefillPeriod < (EvtLim->RefillPeriod * EVT_LIM_MAX_BACKOFF))
+      {
+         Bucket->RefillPeriod *= 2;
+      }
+      Bucket->SuppressedCnt = 0;
+   }
+   else if (Bucket->RefillPeriod > EvtLim->RefillPeriod)
+   {
+      Bucket->RefillPeriod /= 2;
+   }
+
+} /* End AdaptBucket() */
+
+
+/******************************************************************************
+** Function: InitBuckets
+**
+*/
+static void InitBuckets(void)
+{
+
+   EVT_LIM_Bucket_t Bucket;
+
+   Bucket.Tokens        = EvtLim->Burst;
+   Bucket.RefillPeriod  = EvtLim->RefillPeriod;
+   Bucket.LastRefill    = EvtLim->WakeupCnt;
+   Bucket.SuppressedCnt = 0;
+
+   for (uint16 i=0; i < EVT_LIM_EID_CNT; i++)
+   {
+      EvtLim->Eid[i] = Bucket;
+   }
+   for (uint32 i=0; i < JMSG_APP_TOPIC_PLUGIN_CNT; i++)
+   {
+      EvtLim->Topic[i] = Bucket;
+   }
+
+} /* End InitBuckets() */
+
+
+/******************************************************************************
+** Function: RefillBucket
+**
+** Add the tokens earned since the last refill. Tokens aren't accumulated
+** while a bucket is full.
+**
+*/
+static void RefillBucket(EVT_LIM_Bucket_t *Bucket)
+{
+
+   uint32 Elapsed = EvtLim->WakeupCnt - Bucket->LastRefill;
+   uint32 Tokens  = Elapsed / Bucket->RefillPeriod;
+
+   if (Bucket->Tokens >= EvtLim->Burst)
+   {
+      Bucket->LastRefill = EvtLim->WakeupCnt;
+   }
+   else if (Tokens > 0)
+   {
+      Bucket->Tokens      = (Bucket->Tokens + Tokens < EvtLim->Burst) ? (Bucket->Tokens + Tokens) : EvtLim->Burst;
+      Bucket->LastRefill += Tokens * Bucket->RefillPeriod;
+   }
+
+} /* End RefillBucket() */
@@ -0,0 +1,171 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Limit the rate of JMSG_APP event messages
+**
+** Notes:
+**   1. Error events that can be repeated by faults or commands are sent
+**      with EVT_LIM_SendEvent(). Command acknowledgements are sent with
+**      CFE_EVS_SendEvent() so a storm of errors never suppresses the
+**      acknowledgement of a command that succeeded. Each event ID and each
+**      topic plugin has a token bucket that holds EVT_LIM_BURST tokens and
+**      is refilled with one token every EVT_LIM_REFILL_PERIOD wakeups. An
+**      event with a topic plugin must get a token from both buckets so one
+**      faulty topic can't use all of an event ID's tokens.
+**   2. The limits adapt to persistent storms. Every EVT_LIM_REPORT_PERIOD
+**      wakeups a bucket that suppressed events doubles its refill period,
+**      up to EVT_LIM_MAX_BACKOFF times EVT_LIM_REFILL_PERIOD, and a quiet
+**      bucket halves it back toward EVT_LIM_REFILL_PERIOD. One event
+**      reporting the suppressed event count is sent each report period
+**      that suppressed events.
+**   3. Only ERROR events with IDs in the JMSG_APP object ranges, from
+**      JMSG_APP_BASE_EID up to JMSG_APP_END_EID, are limited and use
+**      tokens. Other events are always sent. Events that EVT_LIM doesn't
+**      limit can be filtered by EVS. See EventFilters[] in jmsg_app.c.
+**   4. All functions must be called from the JMSG_APP task. Events sent
+**      from other tasks use CFE_EVS_SendEvent().
+**
+*/
+
+#ifndef _evt_lim_
+#define _evt_lim_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define EVT_LIM_NO_TOPIC     (-1)   /* Topic plugin parameter for events without a topic */
+#define EVT_LIM_MAX_BACKOFF  64
+#define EVT_LIM_EID_CNT      (JMSG_APP_END_EID - JMSG_APP_BASE_EID)
+
+/*
+** Event Message IDs
+*/
+
+#define EVT_LIM_REPORT_EID  (EVT_LIM_BASE_EID + 0)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Token bucket for one event ID or topic plugin
+*/
+
+typedef struct
+{
+
+   uint16  Tokens;
+   uint16  RefillPeriod;   /* Wakeups per token */
+   uint32  LastRefill;     /* Wakeup count when a token was last added */
+   uint32  SuppressedCnt;  /* Since the last report */
+
+} EVT_LIM_Bucket_t;
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   /*
+   ** Configuration
+   */
+
+   uint16  Burst;
+   uint16  RefillPeriod;
+   uint16  ReportPeriod;
+
+   /*
+   ** Class State Data
+   */
+
+   uint32  WakeupCnt;
+   uint32  SuppressedCnt;  /* Since the last reset */
+
+   EVT_LIM_Bucket_t  Eid[EVT_LIM_EID_CNT];
+   EVT_LIM_Bucket_t  Topic[JMSG_APP_TOPIC_PLUGIN_CNT];
+
+} EVT_LIM_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: EVT_LIM_Constructor
+**
+*/
+void EVT_LIM_Constructor(EVT_LIM_Class_t *EvtLimPtr, const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: EVT_LIM_GetSuppressedCnt
+**
+** Return the number of events suppressed since the last reset.
+**
+*/
+uint32 EVT_LIM_GetSuppressedCnt(void);
+
+
+/******************************************************************************
+** Function: EVT_LIM_ResetStatus
+**
+** Clear the suppressed event count and restore every bucket's tokens and
+** refill period.
+**
+*/
+void EVT_LIM_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: EVT_LIM_Run
+**
+** Adapt the refill periods and report suppressed events. Must be called
+** once per wakeup.
+**
+*/
+void EVT_LIM_Run(void);
+
+
+/******************************************************************************
+** Function: EVT_LIM_SendEvent
+**
+** Send an ERROR event message if the event ID's and the topic plugin's
+** buckets have a token. Events of other types are always sent. Returns true
+** if the event was sent.
+**
+** Notes:
+**   1. TopicPlugin is EVT_LIM_NO_TOPIC for events that aren't about a topic
+**      plugin. Invalid topic plugin IDs are only limited by event ID.
+**   2. The message is only formatted when the event is sent.
+**
+*/
+bool EVT_LIM_SendEvent(uint16 EventId, int32 TopicPlugin, uint16 EventType, const char *Spec, ...) OS_PRINTF(4, 5);
+
+
+#endif /* _evt_lim_ */
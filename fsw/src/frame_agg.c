@@ -0,0 +1,264 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the loopback test JSON frame aggregator
+**
+** Notes:
+**   None
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "frame_agg.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define FRAME_HDR            "{\"frame\":["
+#define FRAME_TRAILER        "]}"
+#define FRAME_ENTRY_TOPIC    "{\"topic\":\""
+#define FRAME_ENTRY_PAYLOAD  "\",\"payload\":"
+#define FRAME_ENTRY_END      "}"
+
+#define FRAME_HDR_LEN      (sizeof(FRAME_HDR)-1)
+#define FRAME_TRAILER_LEN  (sizeof(FRAME_TRAILER)-1)
+#define FRAME_ENTRY_LEN    (sizeof(FRAME_ENTRY_TOPIC)-1 + sizeof(FRAME_ENTRY_PAYLOAD)-1 + sizeof(FRAME_ENTRY_END)-1)
+
+#define FRAME_MIN_LEN      (FRAME_HDR_LEN + FRAME_ENTRY_LEN + FRAME_TRAILER_LEN)
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static size_t EscapeString(char *Dst, const char *Src);
+static void   SendFrame(FRAME_AGG_SendFrame_t SendFrameFunc);
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static FRAME_AGG_Class_t *FrameAgg;
+
+
+/******************************************************************************
+** Function: FRAME_AGG_Constructor
+**
+*/
+void FRAME_AGG_Constructor(FRAME_AGG_Class_t *FrameAggPtr, const INITBL_Class_t *IniTbl)
+{
+
+   uint32 MaxFrameLen = INITBL_GetIntConfig(IniTbl, CFG_LOOPBACK_AGG_FRAME_LEN);
+
+   FrameAgg = FrameAggPtr;
+
+   memset((void*)FrameAgg, 0, sizeof(FRAME_AGG_Class_t));
+
+   FrameAgg->FlushPeriodMs = INITBL_GetIntConfig(IniTbl, CFG_LOOPBACK_AGG_FLUSH_PERIOD);
+
+   if (MaxFrameLen == 0)
+   {
+      FrameAgg->Enabled = false;
+   }
+   else if (MaxFrameLen < FRAME_MIN_LEN || MaxFrameLen > (JMSG_APP_AGG_FRAME_MAX_LEN - 1))
+   {
+      EVT_LIM_SendEvent(FRAME_AGG_CONFIG_EID, EVT_LIM_NO_TOPIC, CFE_EVS_EventType_ERROR,
+                        "Loopback test aggregation disabled, LOOPBACK_AGG_FRAME_LEN %d is not in range %d..%d",
+                        (int)MaxFrameLen, (int)FRAME_MIN_LEN, (JMSG_APP_AGG_FRAME_MAX_LEN - 1));
+   }
+   else
+   {
+      FrameAgg->MaxFrameLen = MaxFrameLen;
+      FrameAgg->Enabled     = true;
+   }
+
+} /* End FRAME_AGG_Constructor() */
+
+
+/******************************************************************************
+** Function: FRAME_AGG_AddMsg
+**
+*/
+bool FRAME_AGG_AddMsg(const char *Topic, const char *Payload, FRAME_AGG_SendFrame_t SendFrameFunc)
+{
+
+   bool   RetStatus = false;
+   size_t EntryLen;
+
+   if (FrameAgg->Enabled)
+   {
+
+      EntryLen = FRAME_ENTRY_LEN + EscapeString(NULL, Topic) + strlen(Payload);
+
+      if ((FRAME_HDR_LEN + EntryLen + FRAME_TRAILER_LEN) <= FrameAgg->MaxFrameLen)
+      {
+
+         if (FrameAgg->MsgCnt > 0 && (FrameAgg->FrameLen + 1 + EntryLen + FRAME_TRAILER_LEN) > FrameAgg->MaxFrameLen)
+         {
+            SendFrame(SendFrameFunc);
+         }
+
+         if (FrameAgg->MsgCnt == 0)
+         {
+            strcpy(FrameAgg->Frame, FRAME_HDR);
+            FrameAgg->FrameLen = FRAME_HDR_LEN;
+            OS_GetLocalTime(&FrameAgg->FrameStartTime);
+         }
+         else
+         {
+            FrameAgg->Frame[FrameAgg->FrameLen++] = ',';
+         }
+
+         FrameAgg->FrameLen += sprintf(&FrameAgg->Frame[FrameAgg->FrameLen], FRAME_ENTRY_TOPIC);
+         FrameAgg->FrameLen += EscapeString(&FrameAgg->Frame[FrameAgg->FrameLen], Topic);
+         FrameAgg->FrameLen += sprintf(&FrameAgg->Frame[FrameAgg->FrameLen], FRAME_ENTRY_PAYLOAD "%s" FRAME_ENTRY_END, Payload);
+         FrameAgg->MsgCnt++;
+         FrameAgg->AggMsgCnt++;
+
+         FRAME_AGG_FlushFrame(SendFrameFunc);
+         RetStatus = true;
+
+      } /* End if message fits in a frame */
+
+   } /* End if enabled */
+
+   return RetStatus;
+
+} /* End FRAME_AGG_AddMsg() */
+
+
+/******************************************************************************
+** Function: FRAME_AGG_Clear
+**
+*/
+void FRAME_AGG_Clear(void)
+{
+
+   FrameAgg->MsgCnt    = 0;
+   FrameAgg->FrameLen  = 0;
+   FrameAgg->FrameCnt  = 0;
+   FrameAgg->AggMsgCnt = 0;
+
+} /* End FRAME_AGG_Clear() */
+
+
+/******************************************************************************
+** Function: FRAME_AGG_FlushFrame
+**
+*/
+void FRAME_AGG_FlushFrame(FRAME_AGG_SendFrame_t SendFrameFunc)
+{
+
+   OS_time_t CurrentTime;
+
+   if (FrameAgg->MsgCnt > 0)
+   {
+      OS_GetLocalTime(&CurrentTime);
+      if (OS_TimeGetTotalMilliseconds(OS_TimeSubtract(CurrentTime, FrameAgg->FrameStartTime)) >= FrameAgg->FlushPeriodMs)
+      {
+         SendFrame(SendFrameFunc);
+      }
+   }
+
+} /* End FRAME_AGG_FlushFrame() */
+
+
+/******************************************************************************
+** Function: FRAME_AGG_GetStats
+**
+*/
+void FRAME_AGG_GetStats(uint32 *FrameCnt, uint32 *AggMsgCnt)
+{
+
+   *FrameCnt  = FrameAgg->FrameCnt;
+   *AggMsgCnt = FrameAgg->AggMsgCnt;
+
+} /* End FRAME_AGG_GetStats() */
+
+
+/******************************************************************************
+** Function: EscapeString
+**
+** Write a string's JSON escaped characters to Dst without quotes or a null
+** terminator and return their length. Only the length is computed if Dst
+** is NULL.
+**
+*/
+static size_t EscapeString(char *Dst, const char *Src)
+{
+
+   size_t Len = 0;
+   char   Escaped[8];
+   size_t EscapedLen;
+
+   for (const unsigned char *Char = (const unsigned char *)Src; *Char != '\0'; Char++)
+   {
+
+      if (*Char == '"' || *Char == '\\')
+      {
+         EscapedLen = sprintf(Escaped, "\\%c", *Char);
+      }
+      else if (*Char < 0x20)
+      {
+         EscapedLen = sprintf(Escaped, "\\u%04x", *Char);
+      }
+      else
+      {
+         Escaped[0] = *Char;
+         EscapedLen = 1;
+      }
+
+      if (Dst != NULL)
+      {
+         memcpy(&Dst[Len], Escaped, EscapedLen);
+      }
+      Len += EscapedLen;
+
+   } /* End character loop */
+
+   return Len;
+
+} /* End EscapeString() */
+
+
+/******************************************************************************
+** Function: SendFrame
+**
+** Close the frame's JSON document, send it and start a new frame.
+**
+** Notes:
+**   1. Space for the trailer is reserved when each message is added.
+*/
+static void SendFrame(FRAME_AGG_SendFrame_t SendFrameFunc)
+{
+
+   strcpy(&FrameAgg->Frame[FrameAgg->FrameLen], FRAME_TRAILER);
+   FrameAgg->FrameLen += FRAME_TRAILER_LEN;
+
+   SendFrameFunc(FrameAgg->Frame, FrameAgg->FrameLen);
+
+   FrameAgg->FrameCnt++;
+   FrameAgg->MsgCnt   = 0;
+   FrameAgg->FrameLen = 0;
+
+} /* End SendFrame() */
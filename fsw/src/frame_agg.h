@@ -0,0 +1,154 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Aggregate the loopback test's JSON messages into multi-topic JSON frames
+**
+** Notes:
+**   1. This is a loopback test feature. The JMSG protocol apps send each
+**      JSON topic message themselves and can't call JMSG_APP functions so
+**      no flight topic message is aggregated. The loopback test uses a
+**      frame to measure the latency cost of an aggregation configuration
+**      before a protocol app supports aggregation. See loopback_test.h.
+**   2. When LOOPBACK_AGG_FRAME_LEN is non-zero the loopback test passes each
+**      JSON test message to FRAME_AGG_AddMsg() rather than sending it. The
+**      messages are coalesced into one JSON document with the following
+**      format:
+**
+**         {"frame":[{"topic":"<name>","payload":<json>}, ...]}
+**
+**   3. A frame is sent using the sender's callback when adding a message
+**      would exceed the frame length limit or when the frame's flush period
+**      has expired. The sender must call FRAME_AGG_FlushFrame() each
+**      execution cycle so a partially filled frame isn't held when no new
+**      messages arrive.
+**   4. The frame and counters are only accessed by the JMSG_APP task.
+**
+*/
+
+#ifndef _frame_agg_
+#define _frame_agg_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "evt_lim.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define FRAME_AGG_CONFIG_EID  (FRAME_AGG_BASE_EID + 0)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Sender callback that sends a JSON frame
+*/
+
+typedef void (*FRAME_AGG_SendFrame_t)(const char *Frame, size_t FrameLen);
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   bool       Enabled;
+   uint32     FlushPeriodMs;
+   uint16     MaxFrameLen;
+
+   uint16     MsgCnt;
+   size_t     FrameLen;
+   OS_time_t  FrameStartTime;
+   char       Frame[JMSG_APP_AGG_FRAME_MAX_LEN];
+
+   uint32     FrameCnt;
+   uint32     AggMsgCnt;
+
+} FRAME_AGG_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: FRAME_AGG_Constructor
+**
+** Notes:
+**   1. Aggregation is disabled if LOOPBACK_AGG_FRAME_LEN is 0 or out of
+**      range.
+**
+*/
+void FRAME_AGG_Constructor(FRAME_AGG_Class_t *FrameAggPtr, const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: FRAME_AGG_AddMsg
+**
+** Add a JSON topic message to the frame.
+**
+** Notes:
+**   1. Returns false if aggregation is disabled or the message can't fit in
+**      a frame. The caller must send the message individually.
+**   2. The topic name is escaped as a JSON string.
+**
+*/
+bool FRAME_AGG_AddMsg(const char *Topic, const char *Payload, FRAME_AGG_SendFrame_t SendFrameFunc);
+
+
+/******************************************************************************
+** Function: FRAME_AGG_Clear
+**
+** Discard a partially filled frame and clear the counters. Called when a
+** loopback test is started.
+**
+*/
+void FRAME_AGG_Clear(void);
+
+
+/******************************************************************************
+** Function: FRAME_AGG_FlushFrame
+**
+** Send the frame if its flush period has expired.
+**
+*/
+void FRAME_AGG_FlushFrame(FRAME_AGG_SendFrame_t SendFrameFunc);
+
+
+/******************************************************************************
+** Function: FRAME_AGG_GetStats
+**
+** Return the number of frames sent and messages aggregated since the last
+** clear.
+**
+*/
+void FRAME_AGG_GetStats(uint32 *FrameCnt, uint32 *AggMsgCnt);
+
+
+#endif /* _frame_agg_ */
@@ -24,6 +24,8 @@
 ** Includes
 */
 
+#include <ctype.h>
+#include <stdio.h>
 #include <string.h>
 #include "jmsg_lib.h"
 #include "jmsg_app.h"
@@ -39,14 +41,28 @@
 #define  CMDMGR_OBJ    (&(JMsgApp.CmdMgr))
 #define  TBLMGR_OBJ    (&(JMsgApp.TblMgr))  
 #define  LIBMGR_OBJ    (&(JMsgApp.JMsgLibMgr))
+#define  ATTRTBL_OBJ   (&(JMsgApp.TopicAttrTbl))
+#define  PIPEMON_OBJ   (&(JMsgApp.PipeMon))
+#define  TOPICFWD_OBJ  (&(JMsgApp.TopicFwd))
+#define  FRAMEAGG_OBJ  (&(JMsgApp.FrameAgg))
+#define  LOOPBACK_OBJ  (&(JMsgApp.LoopbackTest))
+#define  BUDGET_OBJ    (&(JMsgApp.WakeupBudget))
+#define  SCHTIME_OBJ   (&(JMsgApp.SchTiming))
+#define  TOPICPART_OBJ (&(JMsgApp.TopicPart))
+#define  TOPICIDX_OBJ  (&(JMsgApp.TopicIdx))
+#define  EVTLIM_OBJ    (&(JMsgApp.EvtLim))
+#define  TOPICCDS_OBJ  (&(JMsgApp.TopicCds))
+#define  TOPICHOOK_OBJ (&(JMsgApp.TopicHook))
 
 
 /*******************************/
 /** Local Function Prototypes **/
 /*******************************/
 
+static const char *GetIniFilename(char *IniFilename, size_t IniFilenameLen);
 static int32 InitApp(void);
 static int32 ProcessCommands(void);
+static void ProcessMsg(const CFE_MSG_Message_t *MsgPtr, OS_time_t RcvTime);
 static void SendStatusPkt(void);
 
 
@@ -60,10 +76,22 @@ static void SendStatusPkt(void);
 */
 DEFINE_ENUM(Config,APP_CONFIG)  
 
+/*
+** Events that EVT_LIM doesn't limit and that can be repeated by commands.
+** They're registered unfiltered so the ground can filter them with EVS
+** commands. CFE_PLATFORM_EVS_MAX_EVENT_FILTERS limits the number of entries.
+*/
 static CFE_EVS_BinFilter_t  EventFilters[] =
 {  
-   /* Event ID          Mask */
-   {JMSG_APP_NOOP_EID,  CFE_EVS_NO_FILTER}    // Placeholder 
+   /* Event ID                        Mask */
+   {JMSG_LIB_MGR_CONFIG_PLUGIN_EID,   CFE_EVS_NO_FILTER},
+   {JMSG_LIB_MGR_START_TOPIC_TEST_EID,CFE_EVS_NO_FILTER},
+   {TOPIC_FWD_CONFIG_RATE_EID,        CFE_EVS_NO_FILTER},
+   {TOPIC_FWD_CONFIG_ON_CHANGE_EID,   CFE_EVS_NO_FILTER},
+   {TOPIC_IDX_REBUILD_EID,            CFE_EVS_NO_FILTER},
+   {LOOPBACK_TEST_CHILD_EID,          CFE_EVS_NO_FILTER},
+   {WAKEUP_BUDGET_OVERRUN_EID,        CFE_EVS_NO_FILTER},
+   {EVT_LIM_REPORT_EID,               CFE_EVS_NO_FILTER}
 };
 
 /*****************/
@@ -100,6 +128,9 @@ void JMSG_AppMain(void)
       
    } /* End CFE_ES_RunLoop */
 
+   TOPIC_HOOK_Remove();
+   LOOPBACK_TEST_DeleteEndpoint();
+
    CFE_ES_WriteToSysLog("JMSG_LIB App terminating, run status = 0x%08X\n", RunStatus);   /* Use SysLog, events may not be working */
 
    CFE_EVS_SendEvent(JMSG_APP_EXIT_EID, CFE_EVS_EventType_CRITICAL, "JMSG_LIB App terminating, run status = 0x%08X", RunStatus);
@@ -141,12 +172,51 @@ bool JMSG_APP_ResetAppCmd(void* ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 
    CMDMGR_ResetStatus(CMDMGR_OBJ);
 	JMSG_LIB_MGR_ResetStatus();
+   PIPE_MON_ResetStatus();
+   TOPIC_FWD_ResetStatus();
+   WAKEUP_BUDGET_ResetStatus();
+   SCH_TIMING_ResetStatus();
+   EVT_LIM_ResetStatus();
         
    return true;
 
 } /* End JMSG_APP_ResetAppCmd() */
 
 
+/******************************************************************************
+** Function: GetIniFilename
+**
+** Notes:
+**   1. The ini filename is created from the cFE app name so each JMSG_APP
+**      instance reads its own ini file. Each instance must be loaded from a
+**      separately named app module (see JMSG_APP_INSTANCES in CMakeLists.txt)
+**      because an instance's objects are file static data and the module's
+**      symbols must not be shared with another instance.
+**
+*/
+static const char *GetIniFilename(char *IniFilename, size_t IniFilenameLen)
+{
+
+   CFE_ES_AppId_t AppId;
+   char AppName[OS_MAX_API_NAME];
+
+   if (CFE_ES_GetAppID(&AppId) != CFE_SUCCESS ||
+       CFE_ES_GetAppName(AppName, AppId, sizeof(AppName)) != CFE_SUCCESS)
+   {
+      return JMSG_APP_INI_FILENAME;
+   }
+
+   for (char *Char = AppName; *Char != '\0'; Char++)
+   {
+      *Char = tolower((unsigned char)*Char);
+   }
+   snprintf(IniFilename, IniFilenameLen, JMSG_APP_INI_FILENAME_FMT, AppName);
+
+   return IniFilename;
+
+} /* End GetIniFilename() */
+
+
 /******************************************************************************
 ** Function: InitApp
 **
@@ -155,13 +225,17 @@ static int32 InitApp(void)
 {
 
    int32 RetStatus = APP_C_FW_CFS_ERROR;
+   char  IniFilename[OS_MAX_PATH_LEN];
    
 
    /*
    ** Read JSON INI Table & class variable defaults defined in JSON  
+   ** - Every object is limited to the topic plugin partition so the app
+   **   isn't initialized with an invalid partition
    */
 
-   if (INITBL_Constructor(INITBL_OBJ, JMSG_APP_INI_FILENAME, &IniCfgEnum))
+   if (INITBL_Constructor(INITBL_OBJ, GetIniFilename(IniFilename, sizeof(IniFilename)), &IniCfgEnum) &&
+       TOPIC_PART_Constructor(TOPICPART_OBJ, INITBL_OBJ))
    {
 
       JMsgApp.PerfId = INITBL_GetIntConfig(INITBL_OBJ, CFG_APP_MAIN_PERF_ID);
@@ -169,13 +243,42 @@ static int32 InitApp(void)
 
       /*
       ** JMSG_LIB owns the JMSG_TOPIC_TBL object so JMSG_LIB must be loaded prior to JMSG_APP
-      ** The table must be loaded prior to calling JMSG_LIB_MGR_Constructor()
+      ** The tables must be loaded prior to calling JMSG_LIB_MGR_Constructor()
+      ** and registration order must match the EDS TblId definitions
+      ** - The topic index is rebuilt when the JMSG topic table is loaded
+      ** - Only the USR_TPLUG owner loads the JMSG topic table. Other instances
+      **   register it so the table IDs match but reject loads
       */
+      EVT_LIM_Constructor(EVTLIM_OBJ, INITBL_OBJ);
+      TOPIC_IDX_Constructor(TOPICIDX_OBJ);
+
       TBLMGR_Constructor(TBLMGR_OBJ, INITBL_GetStrConfig(INITBL_OBJ, CFG_APP_CFE_NAME));
-      TBLMGR_RegisterTblWithDef(TBLMGR_OBJ, JMSG_TOPIC_TBL_NAME, 
-                                JMSG_TOPIC_TBL_LoadCmd, JMSG_TOPIC_TBL_DumpCmd,  
-                                INITBL_GetStrConfig(INITBL_OBJ, CFG_JMSG_TOPIC_TBL_FILE));
+      if (INITBL_GetIntConfig(INITBL_OBJ, CFG_USR_TPLUG_OWNER))
+      {
+         TBLMGR_RegisterTblWithDef(TBLMGR_OBJ, JMSG_TOPIC_TBL_NAME, 
+                                   TOPIC_IDX_LoadTopicTblCmd, JMSG_TOPIC_TBL_DumpCmd,  
+                                   INITBL_GetStrConfig(INITBL_OBJ, CFG_JMSG_TOPIC_TBL_FILE));
+      }
+      else
+      {
+         TBLMGR_RegisterTbl(TBLMGR_OBJ, JMSG_TOPIC_TBL_NAME, 
+                            TOPIC_IDX_RejectTopicTblLoadCmd, JMSG_TOPIC_TBL_DumpCmd);
+      }
 
+      // TOPIC_FWD publishes the forwarding attributes when the attribute table is loaded
+      TOPIC_FWD_Constructor(TOPICFWD_OBJ, INITBL_OBJ);
+      TOPIC_ATTR_TBL_Constructor(ATTRTBL_OBJ);
+      TBLMGR_RegisterTblWithDef(TBLMGR_OBJ, TOPIC_ATTR_TBL_NAME, 
+                                TOPIC_FWD_LoadAttrTblCmd, TOPIC_ATTR_TBL_DumpCmd,  
+                                INITBL_GetStrConfig(INITBL_OBJ, CFG_TOPIC_ATTR_TBL_FILE));
+
+      PIPE_MON_Constructor(PIPEMON_OBJ, INITBL_OBJ);
+      WAKEUP_BUDGET_Constructor(BUDGET_OBJ, INITBL_OBJ);
+      SCH_TIMING_Constructor(SCHTIME_OBJ, INITBL_OBJ);
+      TOPIC_CDS_Constructor(TOPICCDS_OBJ, INITBL_OBJ);
+      TOPIC_HOOK_Constructor(TOPICHOOK_OBJ);
+      FRAME_AGG_Constructor(FRAMEAGG_OBJ, INITBL_OBJ);
+      LOOPBACK_TEST_Constructor(LOOPBACK_OBJ, INITBL_OBJ);
       JMSG_LIB_MGR_Constructor(LIBMGR_OBJ, INITBL_OBJ);
                              
       JMsgApp.CmdMid     = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_JMSG_APP_CMD_TOPICID));
@@ -202,6 +305,9 @@ static int32 InitApp(void)
       CMDMGR_RegisterFunc(CMDMGR_OBJ, JMSG_APP_SEND_TOPIC_TBL_TLM_CC,       NULL, JMSG_TOPIC_TBL_SendTlmCmd,                    0);
       CMDMGR_RegisterFunc(CMDMGR_OBJ, JMSG_APP_START_TOPIC_TEST_CC,         NULL, JMSG_LIB_MGR_StartTopicTestCmd,               sizeof(JMSG_APP_StartTopicTest_CmdPayload_t));
       CMDMGR_RegisterFunc(CMDMGR_OBJ, JMSG_APP_STOP_TOPIC_TEST_CC,          NULL, JMSG_LIB_MGR_StopTopicTestCmd,                0);
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, JMSG_APP_CONFIG_TOPIC_RATE_CC,        NULL, TOPIC_FWD_ConfigTopicRateCmd,                 sizeof(JMSG_APP_ConfigTopicRate_CmdPayload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, JMSG_APP_SEND_TOPIC_STATS_TLM_CC,     NULL, TOPIC_FWD_SendTopicStatsTlmCmd,               sizeof(JMSG_APP_SendTopicStatsTlm_CmdPayload_t));
+      CMDMGR_RegisterFunc(CMDMGR_OBJ, JMSG_APP_CONFIG_TOPIC_ON_CHANGE_CC,   NULL, TOPIC_FWD_ConfigTopicOnChangeCmd,             sizeof(JMSG_APP_ConfigTopicOnChange_CmdPayload_t));
 
       CFE_MSG_Init(CFE_MSG_PTR(JMsgApp.StatusTlm.TelemetryHeader), CFE_SB_ValueToMsgId(INITBL_GetIntConfig(INITBL_OBJ, CFG_JMSG_APP_STATUS_TLM_TOPICID)), sizeof(JMSG_APP_StatusTlm_t));
 
@@ -213,7 +319,7 @@ static int32 InitApp(void)
                         "JMSG_LIB App Initialized. Version %d.%d.%d",
                         JMSG_APP_MAJOR_VER, JMSG_APP_MINOR_VER, JMSG_APP_PLATFORM_REV);
                         
-   } /* End if INITBL Constructed */
+   } /* End if INITBL and TOPIC_PART constructed */
    
    return RetStatus;
 
@@ -223,6 +329,12 @@ static int32 InitApp(void)
 /******************************************************************************
 ** Function: ProcessCommands
 **
+** Notes:
+**   1. All of the messages queued on the command pipe are read after each
+**      wakeup so the pipe monitor can measure the pipe occupancy.
+**   2. Each message is time stamped when CFE_SB_ReceiveBuffer() returns so
+**      the scheduler timing doesn't include the time spent processing
+**      earlier messages in the burst.
 ** 
 */
 static int32 ProcessCommands(void)
@@ -232,49 +344,76 @@ static int32 ProcessCommands(void)
    int32  SysStatus;
 
    CFE_SB_Buffer_t  *SbBufPtr;
-   CFE_SB_MsgId_t   MsgId = CFE_SB_INVALID_MSG_ID;
+   OS_time_t         RcvTime;
 
 
+   PIPE_MON_PendStart();
    CFE_ES_PerfLogExit(JMsgApp.PerfId);
    SysStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, JMsgApp.CmdPipe, CFE_SB_PEND_FOREVER);
+   OS_GetLocalTime(&RcvTime);
    CFE_ES_PerfLogEntry(JMsgApp.PerfId);
+   PIPE_MON_PendEnd();
 
-   if (SysStatus == CFE_SUCCESS)
+   while (SysStatus == CFE_SUCCESS)
    {
-      SysStatus = CFE_MSG_GetMsgId(&SbBufPtr->Msg, &MsgId);
+      PIPE_MON_MsgRcvd();
+      ProcessMsg(&SbBufPtr->Msg, RcvTime);
+      
+      SysStatus = CFE_SB_ReceiveBuffer(&SbBufPtr, JMsgApp.CmdPipe, CFE_SB_POLL);
+      OS_GetLocalTime(&RcvTime);
+   }
+   
+   if (SysStatus != CFE_SB_NO_MESSAGE)
+   {
+      RetStatus = CFE_ES_RunStatus_APP_ERROR;
+   }
 
-      if (SysStatus == CFE_SUCCESS)
-      {
+   return RetStatus;
+   
+} /* End ProcessCommands() */
+
+
+/******************************************************************************
+** Function: ProcessMsg
+**
+** 
+*/
+static void ProcessMsg(const CFE_MSG_Message_t *MsgPtr, OS_time_t RcvTime)
+{
+   
+   CFE_SB_MsgId_t  MsgId = CFE_SB_INVALID_MSG_ID;
 
-         if (CFE_SB_MsgId_Equal(MsgId, JMsgApp.CmdMid))
-         {
-            CMDMGR_DispatchFunc(CMDMGR_OBJ, &SbBufPtr->Msg);
-         } 
-         else if (CFE_SB_MsgId_Equal(MsgId, JMsgApp.ExecuteMid))
-         {   
-            JMSG_LIB_MGR_RunTopicTest();
-            SendStatusPkt();
-         }
-         else
-         {   
-            CFE_EVS_SendEvent(JMSG_APP_INVALID_MID_EID, CFE_EVS_EventType_ERROR,
-                              "Received invalid command packet, MID = 0x%04X(%d)", 
-                              CFE_SB_MsgIdToValue(MsgId), CFE_SB_MsgIdToValue(MsgId));
-         }
-
-      } /* End if got message ID */
-   } /* End if received buffer */
-   else
+   
+   if (CFE_MSG_GetMsgId(MsgPtr, &MsgId) == CFE_SUCCESS)
    {
-      if (SysStatus != CFE_SB_NO_MESSAGE)
+
+      if (CFE_SB_MsgId_Equal(MsgId, JMsgApp.CmdMid))
       {
-         RetStatus = CFE_ES_RunStatus_APP_ERROR;
+         CMDMGR_DispatchFunc(CMDMGR_OBJ, MsgPtr);
+      } 
+      else if (CFE_SB_MsgId_Equal(MsgId, JMsgApp.ExecuteMid))
+      {   
+         SCH_TIMING_WakeupRcvd(RcvTime, PIPE_MON_SchMsgRcvd(MsgPtr));
+         WAKEUP_BUDGET_Start();
+         JMSG_LIB_MGR_RunTopicTest();
+         JMSG_LIB_MGR_RunBroadcast();
+         EVT_LIM_Run();
+         TOPIC_CDS_Run();
+         SendStatusPkt();
+         PIPE_MON_SendPipeHealthTlm();
+         SCH_TIMING_SendSchTimingTlm();
+         WAKEUP_BUDGET_End();
+      }
+      else
+      {   
+         EVT_LIM_SendEvent(JMSG_APP_INVALID_MID_EID, EVT_LIM_NO_TOPIC, CFE_EVS_EventType_ERROR,
+                           "Received invalid command packet, MID = 0x%04X(%d)", 
+                           CFE_SB_MsgIdToValue(MsgId), CFE_SB_MsgIdToValue(MsgId));
       }
-   } 
 
-   return RetStatus;
+   } /* End if got message ID */
    
-} /* End ProcessCommands() */
+} /* End ProcessMsg() */
 
 
 /******************************************************************************
@@ -300,12 +439,23 @@ void SendStatusPkt(void)
    /*
    ** Table Data 
    ** - Loaded with status from the last table action 
+   ** - JMSG_LIB's table may be loaded by another instance's task
    */
 
-   Payload->TopicTblLoaded      = TopicTbl->Loaded;
+   Payload->TopicTblLoaded      = __atomic_load_n(&TopicTbl->Loaded, __ATOMIC_RELAXED);
    Payload->LastTblAction       = LastTbl->LastAction;
    Payload->LastTblActionStatus = LastTbl->LastActionStatus;
    
+   /*
+   ** Contained Object Data
+   */
+   
+   Payload->FirstTopic = TOPIC_PART_First();
+   Payload->LastTopic  = TOPIC_PART_Last();
+   WAKEUP_BUDGET_GetStats(&Payload->WakeupBusyUsec, &Payload->MaxWakeupBusyUsec,
+                          &Payload->BudgetOverrunCnt, &Payload->DeferredWakeupCnt);
+   Payload->SuppressedEventCnt = EVT_LIM_GetSuppressedCnt();
+   
    CFE_SB_TimeStampMsg(CFE_MSG_PTR(JMsgApp.StatusTlm.TelemetryHeader));
    CFE_SB_TransmitMsg(CFE_MSG_PTR(JMsgApp.StatusTlm.TelemetryHeader), true);
 
@@ -30,6 +30,18 @@
 
 #include "app_cfg.h"
 #include "jmsg_lib_mgr.h"
+#include "topic_attr_tbl.h"
+#include "pipe_mon.h"
+#include "topic_fwd.h"
+#include "frame_agg.h"
+#include "loopback_test.h"
+#include "wakeup_budget.h"
+#include "sch_timing.h"
+#include "topic_part.h"
+#include "topic_idx.h"
+#include "evt_lim.h"
+#include "topic_cds.h"
+#include "topic_hook.h"
 
 /***********************/
 /** Macro Definitions **/
@@ -91,7 +103,19 @@ typedef struct
    CFE_SB_MsgId_t  CmdMid;
    CFE_SB_MsgId_t  ExecuteMid;
      
-   JMSG_LIB_MGR_Class_t  JMsgLibMgr;
+   TOPIC_PART_Class_t      TopicPart;
+   TOPIC_IDX_Class_t       TopicIdx;
+   EVT_LIM_Class_t         EvtLim;
+   TOPIC_CDS_Class_t       TopicCds;
+   PIPE_MON_Class_t        PipeMon;
+   TOPIC_ATTR_TBL_Class_t  TopicAttrTbl;
+   TOPIC_FWD_Class_t       TopicFwd;
+   TOPIC_HOOK_Class_t      TopicHook;
+   FRAME_AGG_Class_t       FrameAgg;
+   LOOPBACK_TEST_Class_t   LoopbackTest;
+   WAKEUP_BUDGET_Class_t   WakeupBudget;
+   SCH_TIMING_Class_t      SchTiming;
+   JMSG_LIB_MGR_Class_t    JMsgLibMgr;
    
 } JMSG_APP_Class_t;
 
@@ -27,6 +27,7 @@
 */
 
 #include <string.h>
+#include "cfe_psp.h"
 #include "jmsg_lib.h"
 #include "jmsg_lib_mgr.h"
 #include "usr_tplug.h"
@@ -35,8 +36,11 @@
 /** Local Function Prototypes **/
 /*******************************/
 
-static void SendAllTopicSubscribeTlm(void);
-static void SendTopicSubscribeTlm(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+static bool DisablePlugin(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+static bool EnablePlugin(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+static void RestoreTopics(bool AnnounceChanged);
+static void SendTopicSubscribeTlm(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, uint32 TlmDelay);
+static void StartBroadcast(void);
 
 
 /**********************/
@@ -53,21 +57,45 @@ static JMSG_LIB_MGR_Class_t *JMsgLibMgr;
 void JMSG_LIB_MGR_Constructor(JMSG_LIB_MGR_Class_t *JMsgLibMgrPtr, const INITBL_Class_t *IniTbl)
 {
 
+   bool Restored;
+   bool ProcessorReset;
+
    JMsgLibMgr = JMsgLibMgrPtr;
    
    memset((void*)JMsgLibMgr, 0, sizeof(JMSG_LIB_MGR_Class_t));
 
    JMsgLibMgr->TopicSubscribeTlmDelay = INITBL_GetIntConfig(IniTbl, CFG_TOPIC_SUBSCRIBE_TLM_DELAY);
+   JMsgLibMgr->TopicSubscribeCriticalTlmDelay = INITBL_GetIntConfig(IniTbl, CFG_TOPIC_SUBSCRIBE_CRITICAL_TLM_DELAY);
    
    JMsgLibMgr->TopicSubscribeTlmMid = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_JMSG_LIB_TOPIC_SUBSCRIBE_TLM_TOPICID));
    CFE_MSG_Init(CFE_MSG_PTR(JMsgLibMgr->TopicSubscribeTlm.TelemetryHeader), JMsgLibMgr->TopicSubscribeTlmMid, sizeof(JMSG_LIB_TopicSubscribeTlm_t));
+   CFE_MSG_Init(CFE_MSG_PTR(JMsgLibMgr->TopicEncodingTlm.TelemetryHeader),
+                CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_JMSG_APP_TOPIC_ENCODING_TLM_TOPICID)),
+                sizeof(JMSG_APP_TopicEncodingTlm_t));
 
    // User topic plugins must be created prior to topic subscriptions
-   USR_TPLUG_Constructor();
+   if (INITBL_GetIntConfig(IniTbl, CFG_USR_TPLUG_OWNER))
+   {
+      USR_TPLUG_Constructor();
+   }
+   TOPIC_IDX_Rebuild();
+   TOPIC_HOOK_Install();
 
-   // Allow time for JMSG protocol apps to initialize
-   OS_TaskDelay(INITBL_GetIntConfig(IniTbl, CFG_TOPIC_SUBSCRIBE_STARTUP_DELAY));
-   SendAllTopicSubscribeTlm();
+   // The JMSG protocol apps are also restarted by a processor reset so they need every topic
+   ProcessorReset = (CFE_ES_GetResetType(NULL) == CFE_PSP_RST_TYPE_PROCESSOR);
+   Restored       = TOPIC_CDS_Restored();
+   if (Restored)
+   {
+      RestoreTopics(!ProcessorReset);
+   }
+   if (!Restored || ProcessorReset)
+   {
+      // Allow time for JMSG protocol apps to initialize
+      OS_TaskDelay(INITBL_GetIntConfig(IniTbl, CFG_TOPIC_SUBSCRIBE_STARTUP_DELAY));
+      StartBroadcast();
+      JMSG_LIB_MGR_RunBroadcast();
+   }
+   TOPIC_CDS_Save();
 
 } /* JMSG_LIB_MGR_Constructor() */
 
@@ -82,7 +110,16 @@ void JMSG_LIB_MGR_Constructor(JMSG_LIB_MGR_Class_t *JMsgLibMgrPtr, const INITBL_
 **   2. DataObjPtr is not used.
 **   3. The functions called send error events so this function only needs to
 **      report a successful command. 
-**   4. TODO: No protection against enabling a topic plugin that was never constructed. Is this a problem with stubs?
+**   4. An encoding of JMSG_APP_TopicEncoding_KEEP keeps the topic's current
+**      encoding so a plugin can be re-enabled without knowing it. Any other
+**      encoding is validated before the plugin is enabled and is only set
+**      after the plugin is enabled. A failed enable doesn't change the
+**      encoding. The encoding is applied by the topic's CfeToJson hook so a
+**      message converted between the enable and the encoding change is
+**      sent with the previous encoding.
+**   5. Only topic plugins in this instance's partition can be configured.
+**   6. The topic plugin state is saved in the CDS after a successful change.
+**   7. TODO: No protection against enabling a topic plugin that was never constructed. Is this a problem with stubs?
 **
 */
 bool JMSG_LIB_MGR_ConfigTopicPluginCmd(void *DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
@@ -90,40 +127,50 @@ bool JMSG_LIB_MGR_ConfigTopicPluginCmd(void *DataObjPtr, const CFE_MSG_Message_t
 
    const JMSG_APP_ConfigTopicPlugin_CmdPayload_t *ConfigTopicPlugin = CMDMGR_PAYLOAD_PTR(MsgPtr, JMSG_APP_ConfigTopicPlugin_t);
    bool RetStatus = false;
-   JMSG_TOPIC_TBL_SubscriptionOptEnum_t TopicSubscription;
+   bool KeepEncoding = (ConfigTopicPlugin->Encoding == JMSG_APP_TopicEncoding_KEEP);
    
-   if (ConfigTopicPlugin->Action == APP_C_FW_ConfigEnaAction_ENABLE)
+   if (!TOPIC_PART_Contains(ConfigTopicPlugin->Id))
    {
-      if (JMSG_TOPIC_TBL_EnablePlugin(ConfigTopicPlugin->Id))
+      EVT_LIM_SendEvent(JMSG_LIB_MGR_CONFIG_PLUGIN_EID, ConfigTopicPlugin->Id, CFE_EVS_EventType_ERROR, 
+                        "Configure plugin topic %d command rejected. Topic isn't in this instance's partition %d..%d",
+                        ConfigTopicPlugin->Id, TOPIC_PART_First(), TOPIC_PART_Last());
+   }
+   else if (ConfigTopicPlugin->Action == APP_C_FW_ConfigEnaAction_ENABLE)
+   {
+      if (!KeepEncoding && !TOPIC_ATTR_TBL_ValidEncoding(ConfigTopicPlugin->Encoding))
       {
-         TopicSubscription = JMSG_TOPIC_TBL_SubscribeToTopicMsg(ConfigTopicPlugin->Id, JMSG_TOPIC_TBL_SUB_TO_ROLE);
-         if ((TopicSubscription == JMSG_TOPIC_TBL_SUB_JMSG) || (TopicSubscription == JMSG_TOPIC_TBL_SUB_SB))
-         {
-            RetStatus = true;
-            CFE_EVS_SendEvent(JMSG_LIB_MGR_CONFIG_PLUGIN_EID, CFE_EVS_EventType_INFORMATION, 
-                              "Sucessfully enabled plugin topic %d",ConfigTopicPlugin->Id);
-         }
-         else
+         EVT_LIM_SendEvent(JMSG_LIB_MGR_CONFIG_PLUGIN_EID, ConfigTopicPlugin->Id, CFE_EVS_EventType_ERROR, 
+                           "Configure plugin topic %d command rejected. Invalid encoding %d",
+                           ConfigTopicPlugin->Id, ConfigTopicPlugin->Encoding);
+      }
+      else if (EnablePlugin(ConfigTopicPlugin->Id))
+      {
+         if (!KeepEncoding)
          {
-            JMSG_TOPIC_TBL_DisablePlugin(ConfigTopicPlugin->Id);            
+            TOPIC_FWD_SetEncoding(ConfigTopicPlugin->Id, ConfigTopicPlugin->Encoding);
          }
+         TOPIC_IDX_UpdateTopic(ConfigTopicPlugin->Id);
+         TOPIC_CDS_Save();
+         RetStatus = true;
+         CFE_EVS_SendEvent(JMSG_LIB_MGR_CONFIG_PLUGIN_EID, CFE_EVS_EventType_INFORMATION, 
+                           "Sucessfully enabled plugin topic %d with encoding %d",
+                           ConfigTopicPlugin->Id, TOPIC_ATTR_TBL_GetEncoding(ConfigTopicPlugin->Id));
       }
    }
    else if (ConfigTopicPlugin->Action == APP_C_FW_ConfigEnaAction_DISABLE)
    {
-      if (JMSG_TOPIC_TBL_DisablePlugin(ConfigTopicPlugin->Id))
+      if (DisablePlugin(ConfigTopicPlugin->Id))
       {
-         if (JMSG_TOPIC_TBL_UnsubscribeFromTopicMsg(ConfigTopicPlugin->Id))
-         {
-            RetStatus = true;
-            CFE_EVS_SendEvent(JMSG_LIB_MGR_CONFIG_PLUGIN_EID, CFE_EVS_EventType_INFORMATION, 
-                              "Sucessfully disabled plugin topic %d",ConfigTopicPlugin->Id);
-         }
+         TOPIC_IDX_UpdateTopic(ConfigTopicPlugin->Id);
+         TOPIC_CDS_Save();
+         RetStatus = true;
+         CFE_EVS_SendEvent(JMSG_LIB_MGR_CONFIG_PLUGIN_EID, CFE_EVS_EventType_INFORMATION, 
+                           "Sucessfully disabled plugin topic %d",ConfigTopicPlugin->Id);
       }
    }
    else
    {
-      CFE_EVS_SendEvent(JMSG_LIB_MGR_CONFIG_PLUGIN_EID, CFE_EVS_EventType_ERROR, 
+      EVT_LIM_SendEvent(JMSG_LIB_MGR_CONFIG_PLUGIN_EID, ConfigTopicPlugin->Id, CFE_EVS_EventType_ERROR, 
                         "Configure plugin topic %d command rejected. Invalid action %d",
                         ConfigTopicPlugin->Id, ConfigTopicPlugin->Action);
    }
@@ -145,6 +192,54 @@ void JMSG_LIB_MGR_ResetStatus(void)
 } /* End JMSG_LIB_MGR_ResetStatus() */
 
 
+/******************************************************************************
+** Function: JMSG_LIB_MGR_RunBroadcast
+**
+** Notes:
+**   1. Topics are sent in the priority order defined in the topic attribute
+**      table. Topics with the same priority are sent in topic plugin ID order.
+**   2. CRITICAL topics use a shorter inter-message delay so they are
+**      operational as soon as possible after startup.
+**   3. The broadcast cursor is advanced after each topic is sent so a
+**      deferred broadcast resumes with the next topic.
+**   4. Only the topic plugins in this instance's partition are broadcast.
+*/
+void JMSG_LIB_MGR_RunBroadcast(void)
+{
+
+   uint32 TlmDelay;
+
+   while (JMsgLibMgr->BroadcastActive)
+   {
+
+      if (JMsgLibMgr->BroadcastTopic > TOPIC_PART_Last())
+      {
+         JMsgLibMgr->BroadcastTopic = TOPIC_PART_First();
+         JMsgLibMgr->BroadcastPriority++;
+         JMsgLibMgr->BroadcastActive = (JMsgLibMgr->BroadcastPriority <= JMSG_APP_TopicPriority_Enum_t_MAX);
+      }
+      else if (TOPIC_ATTR_TBL_GetPriority(JMsgLibMgr->BroadcastTopic) != JMsgLibMgr->BroadcastPriority)
+      {
+         JMsgLibMgr->BroadcastTopic++;
+      }
+      else if (WAKEUP_BUDGET_Exhausted())
+      {
+         WAKEUP_BUDGET_Defer();
+         break;
+      }
+      else
+      {
+         TlmDelay = (JMsgLibMgr->BroadcastPriority == JMSG_APP_TopicPriority_CRITICAL) ? 
+                    JMsgLibMgr->TopicSubscribeCriticalTlmDelay : JMsgLibMgr->TopicSubscribeTlmDelay;
+         SendTopicSubscribeTlm(JMsgLibMgr->BroadcastTopic, TlmDelay);
+         JMsgLibMgr->BroadcastTopic++;
+      }
+
+   } /* End broadcast loop */
+
+} /* End JMSG_LIB_MGR_RunBroadcast() */
+
+
 /******************************************************************************
 ** Function: JMSG_LIB_MGR_RunTopicTest
 **
@@ -154,7 +249,19 @@ void JMSG_LIB_MGR_RunTopicTest(void)
    
    if (JMsgLibMgr->TestActive)
    {
-      JMSG_TOPIC_TBL_RunTopicPluginTest(JMsgLibMgr->TestId, false, JMsgLibMgr->TestParam);
+      if (JMsgLibMgr->TestMode == JMSG_APP_TopicTestMode_LOOPBACK)
+      {
+         LOOPBACK_TEST_Run();
+      }
+      else if (WAKEUP_BUDGET_Exhausted())
+      {
+         WAKEUP_BUDGET_Defer();
+         return;
+      }
+      else
+      {
+         JMSG_TOPIC_TBL_RunTopicPluginTest(JMsgLibMgr->TestId, false, JMsgLibMgr->TestParam);
+      }
       JMsgLibMgr->TestExeCnt++;
 
    } /* End if TestActive */
@@ -169,7 +276,7 @@ void JMSG_LIB_MGR_RunTopicTest(void)
 bool JMSG_LIB_MGR_SendAllTopicSubscribeTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
 
-   SendAllTopicSubscribeTlm();
+   StartBroadcast();
 
    return true;
    
@@ -186,15 +293,16 @@ bool JMSG_LIB_MGR_SendTopicSubscribeTlmCmd(void *ObjDataPtr, const CFE_MSG_Messa
 
    bool RetStatus = false;
 
-   if (SendTopicPlugin->Id >= JMSG_PLATFORM_TopicPlugin_Enum_t_MIN && SendTopicPlugin->Id <= JMSG_PLATFORM_TopicPlugin_Enum_t_MAX)
+   if (TOPIC_PART_Contains(SendTopicPlugin->Id))
    {
-      SendTopicSubscribeTlm(SendTopicPlugin->Id);
+      SendTopicSubscribeTlm(SendTopicPlugin->Id, JMsgLibMgr->TopicSubscribeTlmDelay);
       RetStatus = true;
    }
    else
    {
-      CFE_EVS_SendEvent(JMSG_LIB_MGR_SEND_SUBSCRIBE_TLM_EID, CFE_EVS_EventType_ERROR, 
-                        "Send topic subscribe telemetry rejected, invalid topic plugin ID %d", SendTopicPlugin->Id);
+      EVT_LIM_SendEvent(JMSG_LIB_MGR_SEND_SUBSCRIBE_TLM_EID, SendTopicPlugin->Id, CFE_EVS_EventType_ERROR, 
+                        "Send topic subscribe telemetry rejected, topic plugin ID %d isn't in partition %d..%d",
+                        SendTopicPlugin->Id, TOPIC_PART_First(), TOPIC_PART_Last());
    }
    return RetStatus;
       
@@ -205,29 +313,53 @@ bool JMSG_LIB_MGR_SendTopicSubscribeTlmCmd(void *ObjDataPtr, const CFE_MSG_Messa
 /******************************************************************************
 ** Function: JMSG_LIB_MGR_StartTopicTestCmd
 **
+** Notes:
+**   1. A LOOPBACK test measures the round trip latency through a UDP echo
+**      endpoint using the topic plugin's network encoding. See
+**      loopback_test.h.
+**   2. A running test is stopped before the new test is started.
+**
 */
 bool JMSG_LIB_MGR_StartTopicTestCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
    bool RetStatus = false;
    const JMSG_APP_StartTopicTest_CmdPayload_t *StartTest = CMDMGR_PAYLOAD_PTR(MsgPtr, JMSG_APP_StartTopicTest_t);   
                                           
-   if (StartTest->Id >= JMSG_PLATFORM_TopicPlugin_Enum_t_MIN && StartTest->Id <= JMSG_PLATFORM_TopicPlugin_Enum_t_MAX)
+   if (!TOPIC_PART_Contains(StartTest->Id))
+   {
+      EVT_LIM_SendEvent(JMSG_LIB_MGR_START_TOPIC_TEST_EID, StartTest->Id, CFE_EVS_EventType_ERROR, 
+                        "Start test rejected, topic plugin ID %d isn't in partition %d..%d",
+                        StartTest->Id, TOPIC_PART_First(), TOPIC_PART_Last());
+   }
+   else if (StartTest->Mode < JMSG_APP_TopicTestMode_Enum_t_MIN || StartTest->Mode > JMSG_APP_TopicTestMode_Enum_t_MAX)
+   {
+      EVT_LIM_SendEvent(JMSG_LIB_MGR_START_TOPIC_TEST_EID, StartTest->Id, CFE_EVS_EventType_ERROR, 
+                        "Start test rejected, invalid test mode %d", StartTest->Mode);
+   }
+   else
    {
-      JMsgLibMgr->TestActive = true;
+      if (JMsgLibMgr->TestActive && JMsgLibMgr->TestMode == JMSG_APP_TopicTestMode_LOOPBACK)
+      {
+         LOOPBACK_TEST_Stop();
+      }
+      JMsgLibMgr->TestActive = false;
       JMsgLibMgr->TestExeCnt = 0;
       JMsgLibMgr->TestId     = StartTest->Id;
+      JMsgLibMgr->TestMode   = StartTest->Mode;
       JMsgLibMgr->TestParam  = 0;   //TODO: Decide whether need a test parameter   
 
-      CFE_EVS_SendEvent(JMSG_LIB_MGR_START_TOPIC_TEST_EID, CFE_EVS_EventType_INFORMATION, 
-                        "Started test %d", JMsgLibMgr->TestId);
-      
-      JMSG_TOPIC_TBL_RunTopicPluginTest(JMsgLibMgr->TestId, true, JMsgLibMgr->TestParam);
-      RetStatus = true;
-   }
-   else
-   {
-      CFE_EVS_SendEvent(JMSG_LIB_MGR_START_TOPIC_TEST_EID, CFE_EVS_EventType_ERROR, 
-                        "Start test rejected, invalid topic plugin ID %d", JMsgLibMgr->TestId);
+      if (JMsgLibMgr->TestMode == JMSG_APP_TopicTestMode_LOOPBACK)
+      {
+         JMsgLibMgr->TestActive = LOOPBACK_TEST_Start(JMsgLibMgr->TestId);
+      }
+      else
+      {
+         JMsgLibMgr->TestActive = true;
+         CFE_EVS_SendEvent(JMSG_LIB_MGR_START_TOPIC_TEST_EID, CFE_EVS_EventType_INFORMATION, 
+                           "Started test %d", JMsgLibMgr->TestId);
+         JMSG_TOPIC_TBL_RunTopicPluginTest(JMsgLibMgr->TestId, true, JMsgLibMgr->TestParam);
+      }
+      RetStatus = JMsgLibMgr->TestActive;
    }
    
    return RetStatus;
@@ -242,6 +374,11 @@ bool JMSG_LIB_MGR_StartTopicTestCmd(void *ObjDataPtr, const CFE_MSG_Message_t *M
 bool JMSG_LIB_MGR_StopTopicTestCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr)
 {
    
+   if (JMsgLibMgr->TestMode == JMSG_APP_TopicTestMode_LOOPBACK)
+   {
+      LOOPBACK_TEST_Stop();
+   }
+   
    JMsgLibMgr->TestExeCnt = 0;
    JMsgLibMgr->TestActive = false;
 
@@ -254,20 +391,119 @@ bool JMSG_LIB_MGR_StopTopicTestCmd(void *ObjDataPtr, const CFE_MSG_Message_t *Ms
 
 
 /******************************************************************************
-** Function: SendAllTopicSubscribeTlm
+** Function: DisablePlugin
+**
+** Disable a topic plugin and unsubscribe from its topic message.
 **
 */
-static void SendAllTopicSubscribeTlm(void)
+static bool DisablePlugin(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
 {
-   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=JMSG_PLATFORM_TopicPlugin_Enum_t_MIN; i <= JMSG_PLATFORM_TopicPlugin_Enum_t_MAX; i++)
+
+   return (JMSG_TOPIC_TBL_DisablePlugin(TopicPlugin) && JMSG_TOPIC_TBL_UnsubscribeFromTopicMsg(TopicPlugin));
+
+} /* End DisablePlugin() */
+
+
+/******************************************************************************
+** Function: EnablePlugin
+**
+** Enable a topic plugin and subscribe to its topic message. The plugin is
+** disabled if the subscription fails.
+**
+*/
+static bool EnablePlugin(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   bool RetStatus = false;
+   JMSG_TOPIC_TBL_SubscriptionOptEnum_t TopicSubscription;
+
+   if (JMSG_TOPIC_TBL_EnablePlugin(TopicPlugin))
    {
-      SendTopicSubscribeTlm(i);
-      
-   } /* End topic loop */
-   
-} /* SendAllTopicSubscribeTlm() */
+      TopicSubscription = JMSG_TOPIC_TBL_SubscribeToTopicMsg(TopicPlugin, JMSG_TOPIC_TBL_SUB_TO_ROLE);
+      if ((TopicSubscription == JMSG_TOPIC_TBL_SUB_JMSG) || (TopicSubscription == JMSG_TOPIC_TBL_SUB_SB))
+      {
+         RetStatus = true;
+      }
+      else
+      {
+         JMSG_TOPIC_TBL_DisablePlugin(TopicPlugin);
+      }
+   }
+
+   return RetStatus;
+
+} /* End EnablePlugin() */
+
+
+/******************************************************************************
+** Function: RestoreTopics
+**
+** Restore the topic plugin state saved in the CDS.
+**
+** Notes:
+**   1. The encoding and forwarding statistics are restored for every topic
+**      plugin in the partition. Only topic plugins whose enabled state
+**      differs from the topic table are enabled or disabled.
+**   2. After an app restart the protocol apps still have the other topics
+**      so the changed topics are announced with a TopicSubscribeTlm message
+**      and the startup delay and broadcast of all topics are skipped. After
+**      a processor reset the protocol apps were also restarted so the
+**      caller broadcasts all topics and AnnounceChanged is false.
+**   3. If the JMSG protocol apps were restarted without a processor reset
+**      they need all of the topics. Send the SendAllTopicSubscribeTlm
+**      command.
+**
+*/
+static void RestoreTopics(bool AnnounceChanged)
+{
+
+   uint16 ChangedCnt = 0;
+   uint16 ErrCnt     = 0;
+   bool   Changed;
+   const TOPIC_CDS_Topic_t      *CdsTopic;
+   const JMSG_TOPIC_TBL_Topic_t *Topic;
+
+   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); i <= TOPIC_PART_Last(); i++)
+   {
+
+      CdsTopic = TOPIC_CDS_GetTopic(i);
+      Topic    = JMSG_TOPIC_TBL_GetTopic(i);
+      if (CdsTopic == NULL || Topic == NULL)
+      {
+         continue;
+      }
+
+      TOPIC_FWD_SetEncoding(i, CdsTopic->Encoding);
+      TOPIC_FWD_RestoreStats(i, &CdsTopic->FwdStats);
+
+      if (CdsTopic->Enabled != Topic->Enabled)
+      {
+         Changed = CdsTopic->Enabled ? EnablePlugin(i) : DisablePlugin(i);
+         if (Changed)
+         {
+            if (AnnounceChanged)
+            {
+               SendTopicSubscribeTlm(i, JMsgLibMgr->TopicSubscribeTlmDelay);
+            }
+            ChangedCnt++;
+         }
+         else
+         {
+            ErrCnt++;
+         }
+      }
+
+   } /* End topic plugin loop */
+
+   TOPIC_IDX_Rebuild();
+
+   CFE_EVS_SendEvent(JMSG_LIB_MGR_RESTORE_EID, (ErrCnt == 0) ? CFE_EVS_EventType_INFORMATION : CFE_EVS_EventType_ERROR,
+                     "Restored topic plugin state from CDS. %d topic plugins changed, %d failed to change. %s",
+                     ChangedCnt, ErrCnt, AnnounceChanged ? "Changed topics announced" : "Broadcasting all topics after processor reset");
+
+} /* End RestoreTopics() */
+
 
-   
 /******************************************************************************
 ** Function: SendTopicSubscribeTlm
 **
@@ -277,8 +513,14 @@ static void SendAllTopicSubscribeTlm(void)
 **   2. No check are performed to determine whether a topic A SB duplicate
 **      subscription event message will be sent if two subscription requests
 **      are made without an unsubscribe requests between them.
+**   3. The delay suspends the task so it isn't charged to the wakeup budget.
+**      It is charged to the wakeup wall limit which limits the number of
+**      topics sent each wakeup.
+**   4. JMSG_LIB's TopicSubscribeTlm doesn't have an encoding field so the
+**      topic's encoding is advertised in a TopicEncodingTlm message sent
+**      immediately after it.
 */
-static void SendTopicSubscribeTlm(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+static void SendTopicSubscribeTlm(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, uint32 TlmDelay)
 {
 
    JMsgLibMgr->TopicSubscribeTlm.Payload.Id       = TopicPlugin;
@@ -286,7 +528,29 @@ static void SendTopicSubscribeTlm(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
 
    CFE_SB_TimeStampMsg(CFE_MSG_PTR(JMsgLibMgr->TopicSubscribeTlm.TelemetryHeader));
    CFE_SB_TransmitMsg(CFE_MSG_PTR(JMsgLibMgr->TopicSubscribeTlm.TelemetryHeader), true);
-   OS_TaskDelay(JMsgLibMgr->TopicSubscribeTlmDelay);
+
+   JMsgLibMgr->TopicEncodingTlm.Payload.Id       = TopicPlugin;
+   JMsgLibMgr->TopicEncodingTlm.Payload.Protocol = JMsgLibMgr->TopicSubscribeTlm.Payload.Protocol;
+   JMsgLibMgr->TopicEncodingTlm.Payload.Encoding = TOPIC_ATTR_TBL_GetEncoding(TopicPlugin);
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(JMsgLibMgr->TopicEncodingTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(JMsgLibMgr->TopicEncodingTlm.TelemetryHeader), true);
+
+   WAKEUP_BUDGET_Delay(TlmDelay);
       
       
 } /* End SendTopicSubscribeTlm() */
+
+
+/******************************************************************************
+** Function: StartBroadcast
+**
+*/
+static void StartBroadcast(void)
+{
+
+   JMsgLibMgr->BroadcastPriority = JMSG_APP_TopicPriority_Enum_t_MIN;
+   JMsgLibMgr->BroadcastTopic    = TOPIC_PART_First();
+   JMsgLibMgr->BroadcastActive   = true;
+
+} /* End StartBroadcast() */
@@ -32,6 +32,14 @@
 */
 
 #include "app_cfg.h"
+#include "topic_attr_tbl.h"
+#include "loopback_test.h"
+#include "wakeup_budget.h"
+#include "topic_part.h"
+#include "topic_idx.h"
+#include "evt_lim.h"
+#include "topic_cds.h"
+#include "topic_hook.h"
 
 /***********************/
 /** Macro Definitions **/
@@ -45,6 +53,7 @@
 #define JMSG_LIB_MGR_SEND_SUBSCRIBE_TLM_EID (JMSG_LIB_MGR_BASE_EID + 1)
 #define JMSG_LIB_MGR_START_TOPIC_TEST_EID   (JMSG_LIB_MGR_BASE_EID + 2)
 #define JMSG_LIB_MGR_STOP_TOPIC_TEST_EID    (JMSG_LIB_MGR_BASE_EID + 3)
+#define JMSG_LIB_MGR_RESTORE_EID            (JMSG_LIB_MGR_BASE_EID + 4)
 
 /**********************/
 /** Type Definitions **/
@@ -54,12 +63,19 @@
 typedef struct
 {
    uint32                        TopicSubscribeTlmDelay;
+   uint32                        TopicSubscribeCriticalTlmDelay;
    CFE_SB_MsgId_t                TopicSubscribeTlmMid;
    JMSG_LIB_TopicSubscribeTlm_t  TopicSubscribeTlm;
+   JMSG_APP_TopicEncodingTlm_t   TopicEncodingTlm;
      
+   bool                              BroadcastActive;
+   JMSG_APP_TopicPriority_Enum_t     BroadcastPriority;
+   JMSG_PLATFORM_TopicPlugin_Enum_t  BroadcastTopic;
+
    bool    TestActive;
    uint32  TestExeCnt;
    int16   TestParam;
+   JMSG_APP_TopicTestMode_Enum_t     TestMode;
    JMSG_PLATFORM_TopicPlugin_Enum_t  TestId;
    
 } JMSG_LIB_MGR_Class_t;
@@ -75,6 +91,11 @@ typedef struct
 **
 ** Construct and register topic plugins for the JMSG_LIB_MGR app
 **
+** Notes:
+**   1. After a warm restart the topic plugin state saved in the CDS is
+**      restored and only the topic plugins that changed are announced.
+**      Otherwise all of the topics are broadcast after a startup delay.
+**
 */
 void JMSG_LIB_MGR_Constructor(JMSG_LIB_MGR_Class_t *JMsgLibMgrPtr, const INITBL_Class_t *IniTbl);
 
@@ -99,9 +120,25 @@ bool JMSG_LIB_MGR_ConfigTopicPluginCmd(void* DataObjPtr, const CFE_MSG_Message_t
 void JMSG_LIB_MGR_ResetStatus(void);
 
 
+/******************************************************************************
+** Function: JMSG_LIB_MGR_RunBroadcast
+**
+** Continue a SendAllTopicSubscribeTlm broadcast. Called each execution
+** cycle. Topics that don't fit in the wakeup budget are sent during the
+** next execution cycle.
+**
+*/
+void JMSG_LIB_MGR_RunBroadcast(void);
+
+
 /******************************************************************************
 ** Function: JMSG_LIB_MGR_RunTopicTest
 **
+** Notes:
+**   1. A topic plugin test isn't run if the wakeup budget has been used.
+**      Loopback tests send the messages that didn't fit in the budget
+**      during the next execution cycle.
+**
 */
 void JMSG_LIB_MGR_RunTopicTest(void);
 
@@ -109,6 +146,10 @@ void JMSG_LIB_MGR_RunTopicTest(void);
 /******************************************************************************
 ** Function: JMSG_LIB_MGR_SendAllTopicSubscribeTlmCmd
 **
+** Start a broadcast of all topics. The broadcast is sent by
+** JMSG_LIB_MGR_RunBroadcast() so it's limited by the wakeup budget. A
+** broadcast in progress is restarted.
+**
 */
 bool JMSG_LIB_MGR_SendAllTopicSubscribeTlmCmd(void *ObjDataPtr, const CFE_MSG_Message_t *MsgPtr);
 
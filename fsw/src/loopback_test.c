@@ -0,0 +1,894 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the loopback latency test
+**
+** Notes:
+**   1. The main task creates the return message pipe with the sockets and
+**      the child task. See loopback_test.h. The child task is the only task
+**      that reads the return message pipe and the sockets. The main task
+**      only sends to the echo endpoint.
+**   2. StatsMutex protects the counters and round trip samples that are
+**      written by the child task.
+**   3. The datagram buffers can hold a full JSON frame so they are file
+**      data rather than task stack. SendBuf is only used by the main task
+**      and RecvMsg and RecvJson are only used by the child task.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cjson.h"
+#include "jmsg_topic_tbl.h"
+#include "loopback_test.h"
+#include "topic_attr_tbl.h"
+#include "frame_agg.h"
+#include "topic_enc.h"
+#include "topic_idx.h"
+#include "wakeup_budget.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define NUM_STR_MAX_LEN      16
+#define FRAME_QUERY_MAX_LEN  32
+
+/* Zero based index of the nearest rank percentile, ceil(Pct*Cnt/100) - 1 */
+#define NEAREST_RANK_IDX(Cnt, Pct)  ((((uint32)(Cnt) * (Pct)) + 99) / 100 - 1)
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void   ChildTask(void);
+static int    CmpUint32(const void *A, const void *B);
+static bool   CreateEndpoint(void);
+static void   EchoMsg(void);
+static bool   GetUint32(const char *Json, size_t JsonLen, const char *Key, uint32 *Value);
+static void   RecordRoundTrip(const JMSG_APP_LoopbackTestMsg_Payload_t *Payload);
+static bool   ReturnFrame(const char *Json, size_t JsonLen, CFE_SB_PipeId_t ReturnPipe);
+static void   ReturnMsg(CFE_SB_PipeId_t ReturnPipe);
+static bool   ReturnTestMsg(const char *Json, size_t JsonLen, CFE_SB_PipeId_t ReturnPipe);
+static bool   SendEncodedMsg(const char *Json, size_t JsonLen);
+static void   SendFrame(const char *Frame, size_t FrameLen);
+static void   SendTestMsg(const JMSG_APP_LoopbackTestMsg_Payload_t *Payload);
+static void   SendTestTlm(void);
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static LOOPBACK_TEST_Class_t *LoopbackTest;
+
+static OS_time_t  StartTime;
+static uint32     SortedSample[JMSG_APP_LOOPBACK_SAMPLE_CNT];
+
+static uint8      SendBuf[LOOPBACK_TEST_MSG_MAX_LEN];
+static uint8      RecvMsg[LOOPBACK_TEST_MSG_MAX_LEN];
+static char       RecvJson[LOOPBACK_TEST_MSG_MAX_LEN];
+
+
+/******************************************************************************
+** Function: LOOPBACK_TEST_Constructor
+**
+*/
+void LOOPBACK_TEST_Constructor(LOOPBACK_TEST_Class_t *LoopbackTestPtr, const INITBL_Class_t *IniTbl)
+{
+
+   const char *AppName;
+
+   LoopbackTest = LoopbackTestPtr;
+
+   memset((void*)LoopbackTest, 0, sizeof(LOOPBACK_TEST_Class_t));
+
+   LoopbackTest->MsgPerCycle   = INITBL_GetIntConfig(IniTbl, CFG_LOOPBACK_MSG_PER_CYCLE);
+   LoopbackTest->EchoPort      = INITBL_GetIntConfig(IniTbl, CFG_LOOPBACK_ECHO_PORT);
+   LoopbackTest->BridgePort    = INITBL_GetIntConfig(IniTbl, CFG_LOOPBACK_BRIDGE_PORT);
+   LoopbackTest->ChildPriority = INITBL_GetIntConfig(IniTbl, CFG_LOOPBACK_CHILD_PRIORITY);
+   strncpy(LoopbackTest->EchoAddrStr, INITBL_GetStrConfig(IniTbl, CFG_LOOPBACK_ECHO_ADDR), OS_MAX_API_NAME-1);
+
+   AppName = INITBL_GetStrConfig(IniTbl, CFG_APP_CFE_NAME);
+   snprintf(LoopbackTest->ChildTaskName,  OS_MAX_API_NAME, "%s_LB", AppName);
+   snprintf(LoopbackTest->TestPipeName,   OS_MAX_API_NAME, "%s_LB_TEST", AppName);
+   snprintf(LoopbackTest->ReturnPipeName, OS_MAX_API_NAME, "%s_LB_RET", AppName);
+   snprintf(LoopbackTest->MutexName,      OS_MAX_API_NAME, "%s_LB_MUT", AppName);
+
+   LoopbackTest->TestMsgMid   = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_JMSG_APP_LOOPBACK_TEST_MSG_TOPICID));
+   LoopbackTest->ReturnMsgMid = CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_JMSG_APP_LOOPBACK_RETURN_MSG_TOPICID));
+
+   CFE_MSG_Init(CFE_MSG_PTR(LoopbackTest->TestMsg.TelemetryHeader), LoopbackTest->TestMsgMid,
+                sizeof(JMSG_APP_LoopbackTestMsg_t));
+   CFE_MSG_Init(CFE_MSG_PTR(LoopbackTest->ReturnMsg.TelemetryHeader), LoopbackTest->ReturnMsgMid,
+                sizeof(JMSG_APP_LoopbackTestMsg_t));
+   CFE_MSG_Init(CFE_MSG_PTR(LoopbackTest->TestTlm.TelemetryHeader),
+                CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_JMSG_APP_LOOPBACK_TEST_TLM_TOPICID)),
+                sizeof(JMSG_APP_LoopbackTestTlm_t));
+
+} /* End LOOPBACK_TEST_Constructor() */
+
+
+/******************************************************************************
+** Function: LOOPBACK_TEST_DeleteEndpoint
+**
+** Notes:
+**   1. The app may exit before the loopback test was constructed.
+**
+*/
+void LOOPBACK_TEST_DeleteEndpoint(void)
+{
+
+   if (LoopbackTest == NULL)
+   {
+      return;
+   }
+
+   LOOPBACK_TEST_Stop();
+
+   if (LoopbackTest->Created)
+   {
+      __atomic_store_n(&LoopbackTest->ChildExit, true, __ATOMIC_RELEASE);
+      for (int i=0; i < LOOPBACK_TEST_CHILD_EXIT_POLLS && __atomic_load_n(&LoopbackTest->ChildRunning, __ATOMIC_ACQUIRE); i++)
+      {
+         OS_TaskDelay(LOOPBACK_TEST_CHILD_POLL_MS);
+      }
+      if (__atomic_load_n(&LoopbackTest->ChildRunning, __ATOMIC_ACQUIRE))
+      {
+         CFE_ES_DeleteChildTask(LoopbackTest->ChildTaskId);
+      }
+      LoopbackTest->Created = false;
+   }
+
+   if (OS_ObjectIdDefined(LoopbackTest->EchoSocket))
+   {
+      OS_close(LoopbackTest->EchoSocket);
+      LoopbackTest->EchoSocket = OS_OBJECT_ID_UNDEFINED;
+   }
+   if (OS_ObjectIdDefined(LoopbackTest->BridgeSocket))
+   {
+      OS_close(LoopbackTest->BridgeSocket);
+      LoopbackTest->BridgeSocket = OS_OBJECT_ID_UNDEFINED;
+   }
+   if (CFE_RESOURCEID_TEST_DEFINED(LoopbackTest->TestPipe))
+   {
+      CFE_SB_DeletePipe(LoopbackTest->TestPipe);
+      LoopbackTest->TestPipe = CFE_SB_INVALID_PIPE;
+   }
+   if (CFE_RESOURCEID_TEST_DEFINED(LoopbackTest->ReturnPipe))
+   {
+      CFE_SB_DeletePipe(LoopbackTest->ReturnPipe);
+      LoopbackTest->ReturnPipe = CFE_SB_INVALID_PIPE;
+   }
+   if (OS_ObjectIdDefined(LoopbackTest->StatsMutex))
+   {
+      OS_MutSemDelete(LoopbackTest->StatsMutex);
+      LoopbackTest->StatsMutex = OS_OBJECT_ID_UNDEFINED;
+   }
+
+} /* End LOOPBACK_TEST_DeleteEndpoint() */
+
+
+/******************************************************************************
+** Function: LOOPBACK_TEST_Run
+**
+** Notes:
+**   1. Each test message is read back from the SB before it is sent to the
+**      echo endpoint so the measurement includes the SB hop a protocol app
+**      would see.
+**   2. The test protocol's frame is flushed after the messages are sent so
+**      a partially filled frame is sent when its flush period expires.
+**
+*/
+void LOOPBACK_TEST_Run(void)
+{
+
+   OS_time_t        SendTime;
+   CFE_SB_Buffer_t *SbBufPtr;
+
+   if (!LoopbackTest->Active)
+   {
+      return;
+   }
+
+   LoopbackTest->PendingMsgCnt += LoopbackTest->MsgPerCycle;
+   if (LoopbackTest->PendingMsgCnt > 2 * LoopbackTest->MsgPerCycle)
+   {
+      LoopbackTest->PendingMsgCnt = 2 * LoopbackTest->MsgPerCycle;
+   }
+
+   while (LoopbackTest->PendingMsgCnt > 0)
+   {
+
+      if (WAKEUP_BUDGET_Exhausted())
+      {
+         WAKEUP_BUDGET_Defer();
+         break;
+      }
+      LoopbackTest->PendingMsgCnt--;
+
+      OS_GetLocalTime(&SendTime);
+      LoopbackTest->TestMsg.Payload.Seq       = LoopbackTest->NextSeq++;
+      LoopbackTest->TestMsg.Payload.Seconds   = (uint32)OS_TimeGetTotalSeconds(SendTime);
+      LoopbackTest->TestMsg.Payload.Microsecs = OS_TimeGetMicrosecondsPart(SendTime);
+
+      CFE_SB_TransmitMsg(CFE_MSG_PTR(LoopbackTest->TestMsg.TelemetryHeader), true);
+
+      if (CFE_SB_ReceiveBuffer(&SbBufPtr, LoopbackTest->TestPipe, CFE_SB_POLL) == CFE_SUCCESS)
+      {
+         SendTestMsg(&((const JMSG_APP_LoopbackTestMsg_t *)SbBufPtr)->Payload);
+      }
+      else
+      {
+         OS_MutSemTake(LoopbackTest->StatsMutex);
+         LoopbackTest->ErrCnt++;
+         OS_MutSemGive(LoopbackTest->StatsMutex);
+      }
+
+   } /* End message loop */
+
+   FRAME_AGG_FlushFrame(SendFrame);
+
+   SendTestTlm();
+
+} /* End LOOPBACK_TEST_Run() */
+
+
+/******************************************************************************
+** Function: LOOPBACK_TEST_Start
+**
+*/
+bool LOOPBACK_TEST_Start(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   bool RetStatus = false;
+   const JMSG_TOPIC_TBL_Topic_t *Topic;
+
+   if (CreateEndpoint())
+   {
+
+      Topic = JMSG_TOPIC_TBL_GetTopic(TopicPlugin);
+
+      FRAME_AGG_Clear();
+
+      OS_MutSemTake(LoopbackTest->StatsMutex);
+
+      LoopbackTest->Id            = TopicPlugin;
+      strncpy(LoopbackTest->TopicName, (Topic != NULL) ? Topic->Name : "", JMSG_APP_TOPIC_NAME_MAX_LEN-1);
+      LoopbackTest->TopicName[JMSG_APP_TOPIC_NAME_MAX_LEN-1] = '\0';
+      LoopbackTest->PendingMsgCnt = 0;
+      LoopbackTest->NextSeq       = 0;
+      LoopbackTest->ExpectedSeq   = 0;
+      LoopbackTest->SentCnt       = 0;
+      LoopbackTest->RcvdCnt       = 0;
+      LoopbackTest->LostCnt       = 0;
+      LoopbackTest->OutOfOrderCnt = 0;
+      LoopbackTest->ErrCnt        = 0;
+      LoopbackTest->SampleCnt     = 0;
+      LoopbackTest->SampleIdx     = 0;
+      OS_GetLocalTime(&StartTime);
+      LoopbackTest->Active = true;
+
+      OS_MutSemGive(LoopbackTest->StatsMutex);
+
+      CFE_EVS_SendEvent(LOOPBACK_TEST_START_EID, CFE_EVS_EventType_INFORMATION,
+                        "Started loopback test for topic plugin %d, encoding %d, echo endpoint %s:%d",
+                        TopicPlugin, TOPIC_ATTR_TBL_GetEncoding(TopicPlugin),
+                        LoopbackTest->EchoAddrStr, LoopbackTest->EchoPort);
+      RetStatus = true;
+
+   }
+
+   return RetStatus;
+
+} /* End LOOPBACK_TEST_Start() */
+
+
+/******************************************************************************
+** Function: LOOPBACK_TEST_Stop
+**
+*/
+void LOOPBACK_TEST_Stop(void)
+{
+
+   if (LoopbackTest->Active)
+   {
+
+      OS_MutSemTake(LoopbackTest->StatsMutex);
+
+      LoopbackTest->Active = false;
+      if (LoopbackTest->SentCnt > LoopbackTest->RcvdCnt)
+      {
+         LoopbackTest->LostCnt = LoopbackTest->SentCnt - LoopbackTest->RcvdCnt;
+      }
+
+      OS_MutSemGive(LoopbackTest->StatsMutex);
+
+      SendTestTlm();
+
+      CFE_EVS_SendEvent(LOOPBACK_TEST_STOP_EID, CFE_EVS_EventType_INFORMATION,
+                        "Stopped loopback test. Sent %u, received %u, lost %u, out of order %u, errors %u",
+                        LoopbackTest->SentCnt, LoopbackTest->RcvdCnt, LoopbackTest->LostCnt,
+                        LoopbackTest->OutOfOrderCnt, LoopbackTest->ErrCnt);
+   }
+
+} /* End LOOPBACK_TEST_Stop() */
+
+
+/******************************************************************************
+** Function: ChildTask
+**
+** Serve the echo endpoint and return echoed messages to the SB.
+**
+** Notes:
+**   1. The select times out so an exit request from
+**      LOOPBACK_TEST_DeleteEndpoint() is seen within one poll period.
+**   2. The sockets and pipes are owned by the JMSG_APP task so the child
+**      task has nothing to clean up when it exits.
+**
+*/
+static void ChildTask(void)
+{
+
+   OS_FdSet  ReadSet;
+   int32     Status;
+
+   while (!__atomic_load_n(&LoopbackTest->ChildExit, __ATOMIC_ACQUIRE))
+   {
+
+      OS_SelectFdZero(&ReadSet);
+      OS_SelectFdAdd(&ReadSet, LoopbackTest->EchoSocket);
+      OS_SelectFdAdd(&ReadSet, LoopbackTest->BridgeSocket);
+
+      Status = OS_SelectMultiple(&ReadSet, NULL, LOOPBACK_TEST_CHILD_POLL_MS);
+      if (Status == OS_SUCCESS)
+      {
+         if (OS_SelectFdIsSet(&ReadSet, LoopbackTest->EchoSocket))
+         {
+            EchoMsg();
+         }
+         if (OS_SelectFdIsSet(&ReadSet, LoopbackTest->BridgeSocket))
+         {
+            ReturnMsg(LoopbackTest->ReturnPipe);
+         }
+      }
+      else if (Status != OS_ERROR_TIMEOUT)
+      {
+         OS_TaskDelay(100);
+      }
+
+   } /* End task loop */
+
+   CFE_EVS_SendEvent(LOOPBACK_TEST_CHILD_EID, CFE_EVS_EventType_INFORMATION,
+                     "Loopback test child task exiting");
+
+   __atomic_store_n(&LoopbackTest->ChildRunning, false, __ATOMIC_RELEASE);
+
+   CFE_ES_ExitChildTask();
+
+} /* End ChildTask() */
+
+
+/******************************************************************************
+** Function: CmpUint32
+**
+*/
+static int CmpUint32(const void *A, const void *B)
+{
+
+   uint32 ValA = *(const uint32 *)A;
+   uint32 ValB = *(const uint32 *)B;
+
+   return (ValA > ValB) - (ValA < ValB);
+
+} /* End CmpUint32() */
+
+
+/******************************************************************************
+** Function: CreateEndpoint
+**
+** Notes:
+**   1. Resources that were created by a previous start are kept so a failed
+**      start can be retried.
+**
+*/
+static bool CreateEndpoint(void)
+{
+
+   int32 Status = OS_SUCCESS;
+   const char *Resource = "";
+   OS_SockAddr_t BridgeAddr;
+
+   if (LoopbackTest->Created)
+   {
+      return true;
+   }
+
+   if (!OS_ObjectIdDefined(LoopbackTest->StatsMutex))
+   {
+      Resource = "mutex";
+      Status = OS_MutSemCreate(&LoopbackTest->StatsMutex, LoopbackTest->MutexName, 0);
+   }
+
+   if (Status == OS_SUCCESS && !CFE_RESOURCEID_TEST_DEFINED(LoopbackTest->TestPipe))
+   {
+      Resource = "test pipe";
+      Status = CFE_SB_CreatePipe(&LoopbackTest->TestPipe, LoopbackTest->MsgPerCycle, LoopbackTest->TestPipeName);
+      if (Status == CFE_SUCCESS)
+      {
+         Status = CFE_SB_Subscribe(LoopbackTest->TestMsgMid, LoopbackTest->TestPipe);
+      }
+   }
+
+   if (Status == OS_SUCCESS && !CFE_RESOURCEID_TEST_DEFINED(LoopbackTest->ReturnPipe))
+   {
+      Resource = "return pipe";
+      Status = CFE_SB_CreatePipe(&LoopbackTest->ReturnPipe, LoopbackTest->MsgPerCycle, LoopbackTest->ReturnPipeName);
+      if (Status == CFE_SUCCESS)
+      {
+         Status = CFE_SB_Subscribe(LoopbackTest->ReturnMsgMid, LoopbackTest->ReturnPipe);
+      }
+   }
+
+   if (Status == OS_SUCCESS && !OS_ObjectIdDefined(LoopbackTest->EchoSocket))
+   {
+      Resource = "echo socket";
+      OS_SocketAddrInit(&LoopbackTest->EchoAddr, OS_SocketDomain_INET);
+      Status = OS_SocketAddrFromString(&LoopbackTest->EchoAddr, LoopbackTest->EchoAddrStr);
+      if (Status == OS_SUCCESS)
+      {
+         OS_SocketAddrSetPort(&LoopbackTest->EchoAddr, LoopbackTest->EchoPort);
+         Status = OS_SocketOpen(&LoopbackTest->EchoSocket, OS_SocketDomain_INET, OS_SocketType_DATAGRAM);
+      }
+      if (Status == OS_SUCCESS)
+      {
+         Status = OS_SocketBind(LoopbackTest->EchoSocket, &LoopbackTest->EchoAddr);
+      }
+   }
+
+   if (Status == OS_SUCCESS && !OS_ObjectIdDefined(LoopbackTest->BridgeSocket))
+   {
+      Resource = "bridge socket";
+      OS_SocketAddrInit(&BridgeAddr, OS_SocketDomain_INET);
+      OS_SocketAddrFromString(&BridgeAddr, LoopbackTest->EchoAddrStr);
+      OS_SocketAddrSetPort(&BridgeAddr, LoopbackTest->BridgePort);
+      Status = OS_SocketOpen(&LoopbackTest->BridgeSocket, OS_SocketDomain_INET, OS_SocketType_DATAGRAM);
+      if (Status == OS_SUCCESS)
+      {
+         Status = OS_SocketBind(LoopbackTest->BridgeSocket, &BridgeAddr);
+      }
+   }
+
+   if (Status == OS_SUCCESS)
+   {
+      Resource = "child task";
+      LoopbackTest->ChildExit = false;
+      __atomic_store_n(&LoopbackTest->ChildRunning, true, __ATOMIC_RELEASE);
+      Status = CFE_ES_CreateChildTask(&LoopbackTest->ChildTaskId, LoopbackTest->ChildTaskName, ChildTask,
+                                      CFE_ES_TASK_STACK_ALLOCATE, CFE_PLATFORM_ES_DEFAULT_STACK_SIZE,
+                                      LoopbackTest->ChildPriority, 0);
+      if (Status != CFE_SUCCESS)
+      {
+         LoopbackTest->ChildRunning = false;
+      }
+   }
+
+   if (Status == OS_SUCCESS)
+   {
+      LoopbackTest->Created = true;
+   }
+   else
+   {
+      EVT_LIM_SendEvent(LOOPBACK_TEST_SOCKET_EID, EVT_LIM_NO_TOPIC, CFE_EVS_EventType_ERROR,
+                        "Failed to create loopback test %s for %s echo port %d, bridge port %d, status = %d",
+                        Resource, LoopbackTest->EchoAddrStr, LoopbackTest->EchoPort,
+                        LoopbackTest->BridgePort, (int)Status);
+   }
+
+   return LoopbackTest->Created;
+
+} /* End CreateEndpoint() */
+
+
+/******************************************************************************
+** Function: EchoMsg
+**
+** Send a received datagram back to its sender.
+**
+*/
+static void EchoMsg(void)
+{
+
+   OS_SockAddr_t  SenderAddr;
+   int32          MsgLen;
+
+   MsgLen = OS_SocketRecvFrom(LoopbackTest->EchoSocket, RecvMsg, sizeof(RecvMsg), &SenderAddr, OS_CHECK);
+   if (MsgLen > 0)
+   {
+      OS_SocketSendTo(LoopbackTest->EchoSocket, RecvMsg, MsgLen, &SenderAddr);
+   }
+
+} /* End EchoMsg() */
+
+
+/******************************************************************************
+** Function: GetUint32
+**
+*/
+static bool GetUint32(const char *Json, size_t JsonLen, const char *Key, uint32 *Value)
+{
+
+   char   NumStr[NUM_STR_MAX_LEN];
+   char  *JsonValue;
+   size_t JsonValueLen;
+   JSONTypes_t JsonType;
+
+   if (JSON_SearchT((char *)Json, JsonLen, Key, strlen(Key), &JsonValue, &JsonValueLen, &JsonType) != JSONSuccess ||
+       JsonType != JSONNumber || JsonValueLen >= sizeof(NumStr))
+   {
+      return false;
+   }
+
+   memcpy(NumStr, JsonValue, JsonValueLen);
+   NumStr[JsonValueLen] = '\0';
+   *Value = (uint32)strtoul(NumStr, NULL, 10);
+
+   return true;
+
+} /* End GetUint32() */
+
+
+/******************************************************************************
+** Function: RecordRoundTrip
+**
+** Notes:
+**   1. Messages sent before the current test started are ignored.
+**   2. A sequence gap is counted as lost. A lost message that arrives later
+**      is counted as out of order and is removed from the lost count.
+**
+*/
+static void RecordRoundTrip(const JMSG_APP_LoopbackTestMsg_Payload_t *Payload)
+{
+
+   OS_time_t  CurrentTime;
+   OS_time_t  SentTime;
+   int64      RoundTripUsec;
+
+   OS_GetLocalTime(&CurrentTime);
+   SentTime = OS_TimeAssembleFromMicroseconds(Payload->Seconds, Payload->Microsecs);
+   RoundTripUsec = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(CurrentTime, SentTime));
+
+   OS_MutSemTake(LoopbackTest->StatsMutex);
+
+   if (LoopbackTest->Active && OS_TimeGetTotalMicroseconds(OS_TimeSubtract(SentTime, StartTime)) >= 0)
+   {
+
+      LoopbackTest->RcvdCnt++;
+
+      if (Payload->Seq >= LoopbackTest->ExpectedSeq)
+      {
+         LoopbackTest->LostCnt    += Payload->Seq - LoopbackTest->ExpectedSeq;
+         LoopbackTest->ExpectedSeq = Payload->Seq + 1;
+      }
+      else
+      {
+         LoopbackTest->OutOfOrderCnt++;
+         if (LoopbackTest->LostCnt > 0)
+         {
+            LoopbackTest->LostCnt--;
+         }
+      }
+
+      LoopbackTest->Sample[LoopbackTest->SampleIdx] = (RoundTripUsec > 0) ? (uint32)RoundTripUsec : 0;
+      LoopbackTest->SampleIdx = (LoopbackTest->SampleIdx + 1) % JMSG_APP_LOOPBACK_SAMPLE_CNT;
+      if (LoopbackTest->SampleCnt < JMSG_APP_LOOPBACK_SAMPLE_CNT)
+      {
+         LoopbackTest->SampleCnt++;
+      }
+
+   } /* End if active */
+
+   OS_MutSemGive(LoopbackTest->StatsMutex);
+
+} /* End RecordRoundTrip() */
+
+
+/******************************************************************************
+** Function: ReturnFrame
+**
+** Return each test message in an echoed JSON frame.
+**
+** Notes:
+**   1. Returns false if the frame is malformed or contains a message that
+**      isn't for the test topic. Entries before the bad entry are returned.
+**   2. Each entry's topic name is looked up in the topic name index.
+**
+*/
+static bool ReturnFrame(const char *Json, size_t JsonLen, CFE_SB_PipeId_t ReturnPipe)
+{
+
+   bool    RetStatus = true;
+   char    Query[FRAME_QUERY_MAX_LEN];
+   char   *Topic;
+   size_t  TopicLen;
+   char   *Payload;
+   size_t  PayloadLen;
+   JSONTypes_t JsonType;
+   JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin;
+
+   for (int i=0; RetStatus; i++)
+   {
+
+      snprintf(Query, sizeof(Query), "frame[%d].topic", i);
+      if (JSON_SearchT((char *)Json, JsonLen, Query, strlen(Query), &Topic, &TopicLen, &JsonType) != JSONSuccess)
+      {
+         RetStatus = (i > 0);
+         break;
+      }
+
+      snprintf(Query, sizeof(Query), "frame[%d].payload", i);
+      RetStatus = (JsonType == JSONString &&
+                   TOPIC_IDX_GetTopicPluginByName(Topic, TopicLen, &TopicPlugin) &&
+                   TopicPlugin == LoopbackTest->Id &&
+                   JSON_SearchT((char *)Json, JsonLen, Query, strlen(Query), &Payload, &PayloadLen, &JsonType) == JSONSuccess &&
+                   JsonType == JSONObject &&
+                   ReturnTestMsg(Payload, PayloadLen, ReturnPipe));
+
+   } /* End frame entry loop */
+
+   return RetStatus;
+
+} /* End ReturnFrame() */
+
+
+/******************************************************************************
+** Function: ReturnMsg
+**
+** Decode an echoed message or frame, send each test message it contains on
+** the SB and record the round trip of each return message read from the SB.
+**
+*/
+static void ReturnMsg(CFE_SB_PipeId_t ReturnPipe)
+{
+
+   bool             Returned = false;
+   const char      *Json;
+   size_t           JsonLen = 0;
+   int32            MsgLen;
+   char            *Frame;
+   size_t           FrameLen;
+   JSONTypes_t      JsonType;
+   OS_SockAddr_t    SenderAddr;
+   CFE_SB_Buffer_t *SbBufPtr;
+
+   MsgLen = OS_SocketRecvFrom(LoopbackTest->BridgeSocket, RecvMsg, sizeof(RecvMsg), &SenderAddr, OS_CHECK);
+   if (MsgLen > 0)
+   {
+      JsonLen = TOPIC_ENC_DecodeMsg(LoopbackTest->Id, RecvMsg, MsgLen, RecvJson, sizeof(RecvJson), &Json);
+   }
+
+   if (JsonLen > 0)
+   {
+      if (JSON_SearchT((char *)Json, JsonLen, "frame", strlen("frame"), &Frame, &FrameLen, &JsonType) == JSONSuccess)
+      {
+         Returned = (JsonType == JSONArray && ReturnFrame(Json, JsonLen, ReturnPipe));
+      }
+      else
+      {
+         Returned = ReturnTestMsg(Json, JsonLen, ReturnPipe);
+      }
+   }
+
+   if (MsgLen > 0 && !Returned)
+   {
+      OS_MutSemTake(LoopbackTest->StatsMutex);
+      LoopbackTest->ErrCnt++;
+      OS_MutSemGive(LoopbackTest->StatsMutex);
+   }
+
+   while (CFE_SB_ReceiveBuffer(&SbBufPtr, ReturnPipe, CFE_SB_POLL) == CFE_SUCCESS)
+   {
+      RecordRoundTrip(&((const JMSG_APP_LoopbackTestMsg_t *)SbBufPtr)->Payload);
+   }
+
+} /* End ReturnMsg() */
+
+
+/******************************************************************************
+** Function: ReturnTestMsg
+**
+** Send a JSON test message on the SB and record the round trip of each
+** return message read from the SB. The return pipe is drained after each
+** message so a full frame doesn't overflow it.
+**
+*/
+static bool ReturnTestMsg(const char *Json, size_t JsonLen, CFE_SB_PipeId_t ReturnPipe)
+{
+
+   bool RetStatus = false;
+   CFE_SB_Buffer_t *SbBufPtr;
+   JMSG_APP_LoopbackTestMsg_Payload_t *Payload = &LoopbackTest->ReturnMsg.Payload;
+
+   if (GetUint32(Json, JsonLen, "seq", &Payload->Seq) &&
+       GetUint32(Json, JsonLen, "seconds", &Payload->Seconds) &&
+       GetUint32(Json, JsonLen, "microsecs", &Payload->Microsecs))
+   {
+      CFE_SB_TimeStampMsg(CFE_MSG_PTR(LoopbackTest->ReturnMsg.TelemetryHeader));
+      CFE_SB_TransmitMsg(CFE_MSG_PTR(LoopbackTest->ReturnMsg.TelemetryHeader), true);
+      RetStatus = true;
+   }
+
+   while (CFE_SB_ReceiveBuffer(&SbBufPtr, ReturnPipe, CFE_SB_POLL) == CFE_SUCCESS)
+   {
+      RecordRoundTrip(&((const JMSG_APP_LoopbackTestMsg_t *)SbBufPtr)->Payload);
+   }
+
+   return RetStatus;
+
+} /* End ReturnTestMsg() */
+
+
+/******************************************************************************
+** Function: SendEncodedMsg
+**
+** Encode a JSON test message or frame using the test topic's encoding and
+** send it to the echo endpoint. Errors are counted in ErrCnt.
+**
+*/
+static bool SendEncodedMsg(const char *Json, size_t JsonLen)
+{
+
+   bool         RetStatus = false;
+   const uint8 *EncodedMsg;
+   size_t       EncodedLen;
+
+   EncodedLen = TOPIC_ENC_EncodeMsg(LoopbackTest->Id, Json, JsonLen, SendBuf, sizeof(SendBuf), &EncodedMsg);
+
+   if (EncodedLen > 0 &&
+       OS_SocketSendTo(LoopbackTest->BridgeSocket, EncodedMsg, EncodedLen, &LoopbackTest->EchoAddr) == (int32)EncodedLen)
+   {
+      RetStatus = true;
+   }
+   else
+   {
+      OS_MutSemTake(LoopbackTest->StatsMutex);
+      LoopbackTest->ErrCnt++;
+      OS_MutSemGive(LoopbackTest->StatsMutex);
+   }
+
+   return RetStatus;
+
+} /* End SendEncodedMsg() */
+
+
+/******************************************************************************
+** Function: SendFrame
+**
+** FRAME_AGG_SendFrame_t callback that sends a frame to the echo endpoint.
+**
+*/
+static void SendFrame(const char *Frame, size_t FrameLen)
+{
+
+   SendEncodedMsg(Frame, FrameLen);
+
+} /* End SendFrame() */
+
+
+/******************************************************************************
+** Function: SendTestMsg
+**
+** Convert a test message read from the SB to JSON and add it to the
+** frame or send it individually if aggregation is disabled.
+**
+** Notes:
+**   1. SentCnt counts messages. A frame send error is counted once in ErrCnt.
+**
+*/
+static void SendTestMsg(const JMSG_APP_LoopbackTestMsg_Payload_t *Payload)
+{
+
+   char  Json[LOOPBACK_TEST_JSON_MAX_LEN];
+   int   JsonLen;
+
+   JsonLen = snprintf(Json, sizeof(Json), "{\"seq\":%u,\"seconds\":%u,\"microsecs\":%u}",
+                      (unsigned int)Payload->Seq, (unsigned int)Payload->Seconds,
+                      (unsigned int)Payload->Microsecs);
+
+   if (FRAME_AGG_AddMsg(LoopbackTest->TopicName, Json, SendFrame) ||
+       SendEncodedMsg(Json, JsonLen))
+   {
+      LoopbackTest->SentCnt++;
+   }
+
+} /* End SendTestMsg() */
+
+
+/******************************************************************************
+** Function: SendTestTlm
+**
+** Notes:
+**   1. The samples are copied and cleared while the mutex is held and sorted
+**      after it's released so the child task isn't blocked by the sort.
+**   2. Percentiles use the nearest rank of the sorted samples, the smallest
+**      sample with at least P percent of the samples at or below it.
+**
+*/
+static void SendTestTlm(void)
+{
+
+   JMSG_APP_LoopbackTestTlm_Payload_t *Payload = &LoopbackTest->TestTlm.Payload;
+   uint16 SampleCnt;
+   uint64 SampleSum = 0;
+
+   OS_MutSemTake(LoopbackTest->StatsMutex);
+
+   Payload->Id            = LoopbackTest->Id;
+   Payload->Active        = LoopbackTest->Active;
+   Payload->SentCnt       = LoopbackTest->SentCnt;
+   Payload->RcvdCnt       = LoopbackTest->RcvdCnt;
+   Payload->LostCnt       = LoopbackTest->LostCnt;
+   Payload->OutOfOrderCnt = LoopbackTest->OutOfOrderCnt;
+   Payload->ErrCnt        = LoopbackTest->ErrCnt;
+
+   SampleCnt = LoopbackTest->SampleCnt;
+   memcpy(SortedSample, LoopbackTest->Sample, SampleCnt * sizeof(uint32));
+   LoopbackTest->SampleCnt = 0;
+   LoopbackTest->SampleIdx = 0;
+
+   OS_MutSemGive(LoopbackTest->StatsMutex);
+
+   FRAME_AGG_GetStats(&Payload->AggFrameCnt, &Payload->AggMsgCnt);
+
+   Payload->SampleCnt = SampleCnt;
+   if (SampleCnt > 0)
+   {
+
+      qsort(SortedSample, SampleCnt, sizeof(uint32), CmpUint32);
+
+      for (uint16 i=0; i < SampleCnt; i++)
+      {
+         SampleSum += SortedSample[i];
+      }
+
+      Payload->MinUsec  = SortedSample[0];
+      Payload->P50Usec  = SortedSample[NEAREST_RANK_IDX(SampleCnt, 50)];
+      Payload->P90Usec  = SortedSample[NEAREST_RANK_IDX(SampleCnt, 90)];
+      Payload->P99Usec  = SortedSample[NEAREST_RANK_IDX(SampleCnt, 99)];
+      Payload->MaxUsec  = SortedSample[SampleCnt - 1];
+      Payload->MeanUsec = (uint32)(SampleSum / SampleCnt);
+
+   }
+   else
+   {
+      Payload->MinUsec  = 0;
+      Payload->P50Usec  = 0;
+      Payload->P90Usec  = 0;
+      Payload->P99Usec  = 0;
+      Payload->MaxUsec  = 0;
+      Payload->MeanUsec = 0;
+   }
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(LoopbackTest->TestTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(LoopbackTest->TestTlm.TelemetryHeader), true);
+
+} /* End SendTestTlm() */
@@ -0,0 +1,212 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Measure the SB-JSON-network-JSON-SB round trip latency
+**
+** Notes:
+**   1. A loopback test is started with the StartTopicTest command using the
+**      LOOPBACK mode. Each execution cycle LOOPBACK_MSG_PER_CYCLE time
+**      stamped test messages are sent on the SB. Each message is read back
+**      from the SB, converted to JSON, encoded using the test topic's
+**      encoding and sent to a UDP echo endpoint.
+**   2. The echo endpoint stands in for an external JSON network node. It
+**      and the return path run in a child task. Echoed messages are decoded,
+**      converted from JSON and sent on the SB as return messages. The child
+**      task reads the return messages from the SB and records the round
+**      trip time.
+**   3. Round trip percentiles are computed from the samples collected since
+**      the previous LoopbackTestTlm packet. Counters accumulate until the
+**      next test is started.
+**   4. The sockets, child task and pipes are created when the first
+**      loopback test is started so they aren't created if the test is
+**      never used. All of them are created by the JMSG_APP task so a
+**      failure is reported by the start command. They are deleted by
+**      LOOPBACK_TEST_DeleteEndpoint() when the app exits.
+**   5. When the LOOPBACK_AGG_FRAME_LEN ini parameter is non-zero the test
+**      messages are sent in multi-topic JSON frames. See frame_agg.h. The
+**      frame is flushed each execution cycle and the echoed frame entries
+**      are returned individually so the round trip includes the time a
+**      message waits in a frame. Frame entries are matched to the test
+**      topic by name using TOPIC_IDX so the test topic must be enabled or
+**      its entries are counted as errors.
+**
+*/
+
+#ifndef _loopback_test_
+#define _loopback_test_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "evt_lim.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define LOOPBACK_TEST_JSON_MAX_LEN  128                         /* One JSON test message                */
+#define LOOPBACK_TEST_MSG_MAX_LEN   JMSG_APP_AGG_FRAME_MAX_LEN  /* Encoded test message or JSON frame */
+
+#define LOOPBACK_TEST_CHILD_POLL_MS    500  /* Child task checks for an exit request at this period */
+#define LOOPBACK_TEST_CHILD_EXIT_POLLS 4    /* Child exit wait in LOOPBACK_TEST_CHILD_POLL_MS periods */
+
+/*
+** Event Message IDs
+*/
+
+#define LOOPBACK_TEST_START_EID    (LOOPBACK_TEST_BASE_EID + 0)
+#define LOOPBACK_TEST_STOP_EID     (LOOPBACK_TEST_BASE_EID + 1)
+#define LOOPBACK_TEST_SOCKET_EID   (LOOPBACK_TEST_BASE_EID + 2)
+#define LOOPBACK_TEST_CHILD_EID    (LOOPBACK_TEST_BASE_EID + 3)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   /*
+   ** Configuration
+   */
+
+   uint16  MsgPerCycle;
+   uint16  EchoPort;
+   uint16  BridgePort;
+   uint32  ChildPriority;
+   char    EchoAddrStr[OS_MAX_API_NAME];
+
+   /* Resource names are prefixed with APP_CFE_NAME so they're unique for each JMSG_APP instance */
+   char    ChildTaskName[OS_MAX_API_NAME];
+   char    TestPipeName[OS_MAX_API_NAME];
+   char    ReturnPipeName[OS_MAX_API_NAME];
+   char    MutexName[OS_MAX_API_NAME];
+
+   CFE_SB_MsgId_t  TestMsgMid;
+   CFE_SB_MsgId_t  ReturnMsgMid;
+
+   /*
+   ** Endpoint resources created by the first test
+   */
+
+   bool             Created;
+   bool             ChildExit;     /* Set by the JMSG_APP task to request a child task exit */
+   bool             ChildRunning;  /* Cleared by the child task when it exits               */
+   CFE_SB_PipeId_t  TestPipe;
+   CFE_SB_PipeId_t  ReturnPipe;
+   osal_id_t        EchoSocket;
+   osal_id_t        BridgeSocket;
+   OS_SockAddr_t    EchoAddr;
+   osal_id_t        StatsMutex;
+   CFE_ES_TaskId_t  ChildTaskId;
+
+   /*
+   ** Test state. The counters and samples are shared with the child task
+   ** and are protected by StatsMutex.
+   */
+
+   bool    Active;
+   uint16  PendingMsgCnt;
+   uint32  NextSeq;
+   JMSG_PLATFORM_TopicPlugin_Enum_t  Id;
+   char    TopicName[JMSG_APP_TOPIC_NAME_MAX_LEN];
+
+   uint32  SentCnt;
+   uint32  RcvdCnt;
+   uint32  LostCnt;
+   uint32  OutOfOrderCnt;
+   uint32  ErrCnt;
+   uint32  ExpectedSeq;
+   uint16  SampleCnt;
+   uint16  SampleIdx;
+   uint32  Sample[JMSG_APP_LOOPBACK_SAMPLE_CNT];
+
+   JMSG_APP_LoopbackTestMsg_t  TestMsg;
+   JMSG_APP_LoopbackTestMsg_t  ReturnMsg;
+   JMSG_APP_LoopbackTestTlm_t  TestTlm;
+
+} LOOPBACK_TEST_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: LOOPBACK_TEST_Constructor
+**
+*/
+void LOOPBACK_TEST_Constructor(LOOPBACK_TEST_Class_t *LoopbackTestPtr, const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: LOOPBACK_TEST_DeleteEndpoint
+**
+** Stop an active test, stop the child task and delete the endpoint
+** resources. A later test start creates them again.
+**
+** Notes:
+**   1. The child task is deleted if it doesn't exit within
+**      LOOPBACK_TEST_CHILD_EXIT_POLLS poll periods.
+**
+*/
+void LOOPBACK_TEST_DeleteEndpoint(void);
+
+
+/******************************************************************************
+** Function: LOOPBACK_TEST_Run
+**
+** Send a cycle of test messages and the LoopbackTestTlm packet. Called each
+** execution cycle while the test is active.
+**
+** Notes:
+**   1. Messages that don't fit in the wakeup budget are sent during the
+**      next execution cycle. At most one cycle of messages is carried over.
+**
+*/
+void LOOPBACK_TEST_Run(void);
+
+
+/******************************************************************************
+** Function: LOOPBACK_TEST_Start
+**
+** Start a test using a topic plugin's network encoding. Returns false if
+** the echo endpoint can't be created.
+**
+*/
+bool LOOPBACK_TEST_Start(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/******************************************************************************
+** Function: LOOPBACK_TEST_Stop
+**
+** Notes:
+**   1. Messages still in flight are counted as lost and a final
+**      LoopbackTestTlm packet is sent.
+**
+*/
+void LOOPBACK_TEST_Stop(void);
+
+
+#endif /* _loopback_test_ */
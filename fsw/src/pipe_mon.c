@@ -0,0 +1,182 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the command pipe health monitor
+**
+** Notes:
+**   None
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "pipe_mon.h"
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static PIPE_MON_Class_t *PipeMon;
+
+
+/******************************************************************************
+** Function: PIPE_MON_Constructor
+**
+*/
+void PIPE_MON_Constructor(PIPE_MON_Class_t *PipeMonPtr, const INITBL_Class_t *IniTbl)
+{
+
+   PipeMon = PipeMonPtr;
+
+   memset((void*)PipeMon, 0, sizeof(PIPE_MON_Class_t));
+
+   PipeMon->PipeDepth = INITBL_GetIntConfig(IniTbl, CFG_CMD_PIPE_DEPTH);
+   OS_GetLocalTime(&PipeMon->PendEndTime);
+
+   CFE_MSG_Init(CFE_MSG_PTR(PipeMon->PipeHealthTlm.TelemetryHeader),
+                CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_JMSG_APP_PIPE_HEALTH_TLM_TOPICID)),
+                sizeof(JMSG_APP_PipeHealthTlm_t));
+
+} /* End PIPE_MON_Constructor() */
+
+
+/******************************************************************************
+** Function: PIPE_MON_MsgRcvd
+**
+*/
+void PIPE_MON_MsgRcvd(void)
+{
+
+   PipeMon->BurstMsgCnt++;
+   PipeMon->WakeupMsgCnt++;
+
+} /* End PIPE_MON_MsgRcvd() */
+
+
+/******************************************************************************
+** Function: PIPE_MON_PendEnd
+**
+*/
+void PIPE_MON_PendEnd(void)
+{
+
+   OS_GetLocalTime(&PipeMon->PendEndTime);
+   PipeMon->BlockedTimeUsec += (uint32)OS_TimeGetTotalMicroseconds(OS_TimeSubtract(PipeMon->PendEndTime, PipeMon->PendStartTime));
+
+} /* End PIPE_MON_PendEnd() */
+
+
+/******************************************************************************
+** Function: PIPE_MON_PendStart
+**
+*/
+void PIPE_MON_PendStart(void)
+{
+
+   OS_GetLocalTime(&PipeMon->PendStartTime);
+   PipeMon->BusyTimeUsec += (uint32)OS_TimeGetTotalMicroseconds(OS_TimeSubtract(PipeMon->PendStartTime, PipeMon->PendEndTime));
+
+   if (PipeMon->BurstMsgCnt > PipeMon->MsgHighWater)
+   {
+      PipeMon->MsgHighWater = PipeMon->BurstMsgCnt;
+   }
+   if (PipeMon->BurstMsgCnt >= PipeMon->PipeDepth)
+   {
+      PipeMon->DepthBurstCnt++;
+   }
+   PipeMon->BurstMsgCnt = 0;
+
+} /* End PIPE_MON_PendStart() */
+
+
+/******************************************************************************
+** Function: PIPE_MON_ResetStatus
+**
+*/
+void PIPE_MON_ResetStatus(void)
+{
+
+   PipeMon->MsgHighWater    = 0;
+   PipeMon->DepthBurstCnt   = 0;
+   PipeMon->MaxWakeupMsgCnt = 0;
+   PipeMon->SchMsgLostCnt   = 0;
+
+} /* End PIPE_MON_ResetStatus() */
+
+
+/******************************************************************************
+** Function: PIPE_MON_SchMsgRcvd
+**
+*/
+uint32 PIPE_MON_SchMsgRcvd(const CFE_MSG_Message_t *MsgPtr)
+{
+
+   CFE_MSG_SequenceCount_t SeqCnt;
+   uint32 LostCnt = 0;
+
+   if (CFE_MSG_GetSequenceCount(MsgPtr, &SeqCnt) == CFE_SUCCESS)
+   {
+      /* A repeated count means the sender doesn't maintain the counter */
+      if (PipeMon->SchSeqCntValid && SeqCnt != PipeMon->SchSeqCnt &&
+          SeqCnt != CFE_MSG_GetNextSequenceCount(PipeMon->SchSeqCnt))
+      {
+         LostCnt = (SeqCnt - PipeMon->SchSeqCnt - 1) & PIPE_MON_SEQ_CNT_MASK;
+         PipeMon->SchMsgLostCnt += LostCnt;
+      }
+      PipeMon->SchSeqCnt      = SeqCnt;
+      PipeMon->SchSeqCntValid = true;
+   }
+
+   PipeMon->LastWakeupMsgCnt = PipeMon->WakeupMsgCnt;
+   if (PipeMon->WakeupMsgCnt > PipeMon->MaxWakeupMsgCnt)
+   {
+      PipeMon->MaxWakeupMsgCnt = PipeMon->WakeupMsgCnt;
+   }
+   PipeMon->WakeupMsgCnt = 0;
+
+   return LostCnt;
+
+} /* End PIPE_MON_SchMsgRcvd() */
+
+
+/******************************************************************************
+** Function: PIPE_MON_SendPipeHealthTlm
+**
+*/
+void PIPE_MON_SendPipeHealthTlm(void)
+{
+
+   JMSG_APP_PipeHealthTlm_Payload_t *Payload = &PipeMon->PipeHealthTlm.Payload;
+
+   Payload->PipeDepth        = PipeMon->PipeDepth;
+   Payload->MsgHighWater     = PipeMon->MsgHighWater;
+   Payload->DepthBurstCnt    = PipeMon->DepthBurstCnt;
+   Payload->SchMsgLostCnt    = PipeMon->SchMsgLostCnt;
+   Payload->WakeupMsgCnt     = PipeMon->LastWakeupMsgCnt;
+   Payload->MaxWakeupMsgCnt  = PipeMon->MaxWakeupMsgCnt;
+   Payload->BlockedTimeMsec  = PipeMon->BlockedTimeUsec / 1000;
+   Payload->BusyTimeMsec     = PipeMon->BusyTimeUsec / 1000;
+
+   PipeMon->BlockedTimeUsec = 0;
+   PipeMon->BusyTimeUsec    = 0;
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(PipeMon->PipeHealthTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(PipeMon->PipeHealthTlm.TelemetryHeader), true);
+
+} /* End PIPE_MON_SendPipeHealthTlm() */
@@ -0,0 +1,161 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Monitor the health of JMSG_APP's command pipe
+**
+** Notes:
+**   1. SB does not provide a pipe occupancy query so occupancy is estimated
+**      as the number of messages read from the pipe in one burst after the
+**      app wakes up. A burst also includes messages that arrived while the
+**      burst was being processed so a burst of at least the pipe depth
+**      (DepthBurstCnt) means the pipe may have been full, not that it
+**      overflowed. SB only reports pipe overflows in its global housekeeping
+**      counter so this can't be derived per pipe.
+**   2. SB pipe overflows are detected using gaps in the scheduler message
+**      sequence counter. Ground commands don't have reliable sequence
+**      counters so command overflows can't be detected. A scheduler message
+**      with the same sequence count as the previous one carries no sequence
+**      information, for example when the sender doesn't increment the
+**      count, so it isn't counted as a loss.
+**
+*/
+
+#ifndef _pipe_mon_
+#define _pipe_mon_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define PIPE_MON_SEQ_CNT_MASK  0x3FFF  /* CCSDS 14-bit sequence counter */
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   JMSG_APP_PipeHealthTlm_t  PipeHealthTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   uint16  PipeDepth;
+   uint16  BurstMsgCnt;
+   uint16  MsgHighWater;
+   uint32  DepthBurstCnt;
+
+   uint16  WakeupMsgCnt;
+   uint16  LastWakeupMsgCnt;
+   uint16  MaxWakeupMsgCnt;
+
+   bool    SchSeqCntValid;
+   CFE_MSG_SequenceCount_t SchSeqCnt;
+   uint32  SchMsgLostCnt;
+
+   OS_time_t  PendStartTime;
+   OS_time_t  PendEndTime;
+   uint32     BlockedTimeUsec;
+   uint32     BusyTimeUsec;
+
+} PIPE_MON_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: PIPE_MON_Constructor
+**
+*/
+void PIPE_MON_Constructor(PIPE_MON_Class_t *PipeMonPtr, const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: PIPE_MON_MsgRcvd
+**
+** Account for a message read from the command pipe.
+**
+*/
+void PIPE_MON_MsgRcvd(void);
+
+
+/******************************************************************************
+** Function: PIPE_MON_PendEnd
+**
+** Must be called when the app returns from pending on the command pipe.
+**
+*/
+void PIPE_MON_PendEnd(void);
+
+
+/******************************************************************************
+** Function: PIPE_MON_PendStart
+**
+** Must be called just before the app pends on the command pipe. It closes
+** the message burst read since the last PIPE_MON_PendEnd().
+**
+*/
+void PIPE_MON_PendStart(void);
+
+
+/******************************************************************************
+** Function: PIPE_MON_ResetStatus
+**
+*/
+void PIPE_MON_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: PIPE_MON_SchMsgRcvd
+**
+** Account for a scheduler wakeup message. Returns the number of scheduler
+** messages lost since the previous wakeup message.
+**
+*/
+uint32 PIPE_MON_SchMsgRcvd(const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: PIPE_MON_SendPipeHealthTlm
+**
+** Notes:
+**   1. Blocked and busy times are accumulated between telemetry messages.
+**
+*/
+void PIPE_MON_SendPipeHealthTlm(void);
+
+
+#endif /* _pipe_mon_ */
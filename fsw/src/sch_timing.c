@@ -0,0 +1,196 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the scheduler wakeup timing monitor
+**
+** Notes:
+**   None
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "sch_timing.h"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void ResetPeriodStats(void);
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static SCH_TIMING_Class_t *SchTiming;
+
+
+/******************************************************************************
+** Function: SCH_TIMING_Constructor
+**
+*/
+void SCH_TIMING_Constructor(SCH_TIMING_Class_t *SchTimingPtr, const INITBL_Class_t *IniTbl)
+{
+
+   SchTiming = SchTimingPtr;
+
+   memset((void*)SchTiming, 0, sizeof(SCH_TIMING_Class_t));
+
+   SchTiming->ExpectedPeriodUsec = INITBL_GetIntConfig(IniTbl, CFG_SCH_EXPECTED_PERIOD) * 1000;
+   SchTiming->ToleranceUsec      = INITBL_GetIntConfig(IniTbl, CFG_SCH_PERIOD_TOLERANCE) * 1000;
+   SchTiming->TlmPeriod          = INITBL_GetIntConfig(IniTbl, CFG_SCH_TIMING_TLM_PERIOD);
+
+   ResetPeriodStats();
+
+   CFE_MSG_Init(CFE_MSG_PTR(SchTiming->SchTimingTlm.TelemetryHeader),
+                CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_JMSG_APP_SCH_TIMING_TLM_TOPICID)),
+                sizeof(JMSG_APP_SchTimingTlm_t));
+
+} /* End SCH_TIMING_Constructor() */
+
+
+/******************************************************************************
+** Function: SCH_TIMING_ResetStatus
+**
+*/
+void SCH_TIMING_ResetStatus(void)
+{
+
+   SchTiming->LateCnt   = 0;
+   SchTiming->EarlyCnt  = 0;
+
+} /* End SCH_TIMING_ResetStatus() */
+
+
+/******************************************************************************
+** Function: SCH_TIMING_SendSchTimingTlm
+**
+*/
+void SCH_TIMING_SendSchTimingTlm(void)
+{
+
+   JMSG_APP_SchTimingTlm_Payload_t *Payload = &SchTiming->SchTimingTlm.Payload;
+
+   if (++SchTiming->TlmWakeupCnt < SchTiming->TlmPeriod)
+   {
+      return;
+   }
+
+   Payload->ExpectedPeriodUsec = SchTiming->ExpectedPeriodUsec;
+   Payload->WakeupCnt          = SchTiming->WakeupCnt;
+   Payload->LastPeriodUsec     = SchTiming->LastPeriodUsec;
+   Payload->LateCnt            = SchTiming->LateCnt;
+   Payload->EarlyCnt           = SchTiming->EarlyCnt;
+
+   if (SchTiming->WakeupCnt > 0)
+   {
+      Payload->MinPeriodUsec  = SchTiming->MinPeriodUsec;
+      Payload->MaxPeriodUsec  = SchTiming->MaxPeriodUsec;
+      Payload->MeanPeriodUsec = (uint32)(SchTiming->PeriodSumUsec / SchTiming->WakeupCnt);
+      Payload->MaxJitterUsec  = SchTiming->MaxJitterUsec;
+      Payload->MeanJitterUsec = (uint32)(SchTiming->JitterSumUsec / SchTiming->WakeupCnt);
+   }
+   else
+   {
+      Payload->MinPeriodUsec  = 0;
+      Payload->MaxPeriodUsec  = 0;
+      Payload->MeanPeriodUsec = 0;
+      Payload->MaxJitterUsec  = 0;
+      Payload->MeanJitterUsec = 0;
+   }
+
+   ResetPeriodStats();
+
+   CFE_SB_TimeStampMsg(CFE_MSG_PTR(SchTiming->SchTimingTlm.TelemetryHeader));
+   CFE_SB_TransmitMsg(CFE_MSG_PTR(SchTiming->SchTimingTlm.TelemetryHeader), true);
+
+} /* End SCH_TIMING_SendSchTimingTlm() */
+
+
+/******************************************************************************
+** Function: SCH_TIMING_WakeupRcvd
+**
+*/
+void SCH_TIMING_WakeupRcvd(OS_time_t RcvTime, uint32 LostCnt)
+{
+
+   uint32     PeriodUsec;
+   uint32     JitterUsec;
+
+   if (SchTiming->LastWakeupValid && SchTiming->ExpectedPeriodUsec > 0 && LostCnt == 0)
+   {
+
+      PeriodUsec = (uint32)OS_TimeGetTotalMicroseconds(OS_TimeSubtract(RcvTime, SchTiming->LastWakeupTime));
+      JitterUsec = (PeriodUsec > SchTiming->ExpectedPeriodUsec) ?
+                   (PeriodUsec - SchTiming->ExpectedPeriodUsec) : (SchTiming->ExpectedPeriodUsec - PeriodUsec);
+
+      SchTiming->WakeupCnt++;
+      SchTiming->LastPeriodUsec = PeriodUsec;
+      SchTiming->PeriodSumUsec += PeriodUsec;
+      SchTiming->JitterSumUsec += JitterUsec;
+      if (PeriodUsec < SchTiming->MinPeriodUsec)
+      {
+         SchTiming->MinPeriodUsec = PeriodUsec;
+      }
+      if (PeriodUsec > SchTiming->MaxPeriodUsec)
+      {
+         SchTiming->MaxPeriodUsec = PeriodUsec;
+      }
+      if (JitterUsec > SchTiming->MaxJitterUsec)
+      {
+         SchTiming->MaxJitterUsec = JitterUsec;
+      }
+
+      if (JitterUsec > SchTiming->ToleranceUsec)
+      {
+         if (PeriodUsec > SchTiming->ExpectedPeriodUsec)
+         {
+            SchTiming->LateCnt++;
+         }
+         else
+         {
+            SchTiming->EarlyCnt++;
+         }
+      }
+
+   } /* End if LastWakeupValid */
+
+   SchTiming->LastWakeupTime  = RcvTime;
+   SchTiming->LastWakeupValid = true;
+
+} /* End SCH_TIMING_WakeupRcvd() */
+
+
+/******************************************************************************
+** Function: ResetPeriodStats
+**
+*/
+static void ResetPeriodStats(void)
+{
+
+   SchTiming->TlmWakeupCnt  = 0;
+   SchTiming->WakeupCnt     = 0;
+   SchTiming->MinPeriodUsec = UINT32_MAX;
+   SchTiming->MaxPeriodUsec = 0;
+   SchTiming->PeriodSumUsec = 0;
+   SchTiming->MaxJitterUsec = 0;
+   SchTiming->JitterSumUsec = 0;
+
+} /* End ResetPeriodStats() */
@@ -0,0 +1,127 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Measure the scheduler wakeup period and jitter
+**
+** Notes:
+**   1. Each wakeup is time stamped when CFE_SB_ReceiveBuffer() returns it.
+**      Scheduler messages are commands without a time stamp so the SB send
+**      time isn't available. A wakeup queued behind other messages or
+**      received while the app is suspended is measured as late and the
+**      wakeup that follows it as early.
+**   2. Lost wakeups are only counted by PipeHealthTlm's SchMsgLostCnt which
+**      uses the scheduler message sequence counter. A period that spans a
+**      lost wakeup isn't measured. A longer period without a lost message
+**      means the scheduler sent the wakeup late and is counted as late.
+**   3. Period and jitter statistics are computed over the wakeups between
+**      SchTimingTlm packets. Late and early counts accumulate until a
+**      reset.
+**
+*/
+
+#ifndef _sch_timing_
+#define _sch_timing_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   JMSG_APP_SchTimingTlm_t  SchTimingTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   uint32     ExpectedPeriodUsec;
+   uint32     ToleranceUsec;
+   uint16     TlmPeriod;
+
+   bool       LastWakeupValid;
+   OS_time_t  LastWakeupTime;
+   uint16     TlmWakeupCnt;
+
+   uint16     WakeupCnt;
+   uint32     LastPeriodUsec;
+   uint32     MinPeriodUsec;
+   uint32     MaxPeriodUsec;
+   uint64     PeriodSumUsec;
+   uint32     MaxJitterUsec;
+   uint64     JitterSumUsec;
+
+   uint32     LateCnt;
+   uint32     EarlyCnt;
+
+} SCH_TIMING_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: SCH_TIMING_Constructor
+**
+*/
+void SCH_TIMING_Constructor(SCH_TIMING_Class_t *SchTimingPtr, const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: SCH_TIMING_ResetStatus
+**
+*/
+void SCH_TIMING_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: SCH_TIMING_SendSchTimingTlm
+**
+** Send the SchTimingTlm packet when SCH_TIMING_TLM_PERIOD wakeups have been
+** received since the last packet. Must be called once per wakeup.
+**
+*/
+void SCH_TIMING_SendSchTimingTlm(void);
+
+
+/******************************************************************************
+** Function: SCH_TIMING_WakeupRcvd
+**
+** Account for a scheduler wakeup message received at RcvTime. LostCnt is
+** the number of scheduler messages lost since the previous wakeup.
+**
+*/
+void SCH_TIMING_WakeupRcvd(OS_time_t RcvTime, uint32 LostCnt);
+
+
+#endif /* _sch_timing_ */
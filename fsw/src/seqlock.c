@@ -0,0 +1,78 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the seqlock snapshot reader
+**
+** Notes:
+**   None
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include "seqlock.h"
+
+
+/******************************************************************************
+** Function: SEQLOCK_ReadSnapshot
+**
+** Notes:
+**   1. Each word is read atomically so the copy doesn't tear a word on
+**      targets where memcpy may copy bytes.
+**
+*/
+bool SEQLOCK_ReadSnapshot(const uint32 *Seq, const void *Set, void *Snapshot, size_t SetSize, uint32 DelayLim)
+{
+
+   const uint32 *Src = (const uint32 *)Set;
+   uint32       *Dst = (uint32 *)Snapshot;
+   uint32 SeqStart;
+   uint32 SpinCnt  = 0;
+   uint32 DelayCnt = 0;
+   bool   Consistent = false;
+
+   while (!Consistent)
+   {
+
+      SeqStart = __atomic_load_n(Seq, __ATOMIC_ACQUIRE);
+
+      if ((SeqStart & 1) == 0)
+      {
+         for (size_t i=0; i < SetSize / sizeof(uint32); i++)
+         {
+            Dst[i] = __atomic_load_n(&Src[i], __ATOMIC_RELAXED);
+         }
+         __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+         Consistent = (__atomic_load_n(Seq, __ATOMIC_RELAXED) == SeqStart);
+      }
+
+      if (!Consistent && ++SpinCnt >= SEQLOCK_READ_SPIN_CNT)
+      {
+         if (DelayCnt++ >= DelayLim)
+         {
+            break;
+         }
+         OS_TaskDelay(1);
+         SpinCnt = 0;
+      }
+
+   } /* End read loop */
+
+   return Consistent;
+
+} /* End SEQLOCK_ReadSnapshot() */
@@ -0,0 +1,124 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Share a set of uint32 words between a writer task and reader tasks
+**
+** Notes:
+**   1. A set is written by one task and read by other tasks. The writer
+**      never blocks. A reader copies a consistent snapshot of the set using
+**      a sequence counter that is odd while the writer is updating the set.
+**      JMSG protocol apps write topic statistics that JMSG_APP reads and
+**      JMSG_APP writes topic forwarding configurations that the protocol
+**      apps read.
+**   2. A set must only contain uint32 words and must only be written by
+**      one task. Readers must not write the set. Counters are reset by
+**      saving a snapshot and subtracting it from later snapshots.
+**   3. A reader that runs at a higher priority than the writer could spin
+**      while the writer is preempted during an update, so the reader
+**      delays after SEQLOCK_READ_SPIN_CNT attempts and gives up after a
+**      caller defined number of delays. Readers in a message path pass 0
+**      so they never block.
+**   4. The GCC __atomic builtins are used since cFS targets are built with
+**      GCC compatible compilers.
+**
+*/
+
+#ifndef _seqlock_
+#define _seqlock_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define SEQLOCK_READ_SPIN_CNT   16
+#define SEQLOCK_READ_DELAY_LIM  10  /* Default reader limit, one OS_TaskDelay(1) per delay */
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: SEQLOCK_IncCnt
+**
+** Increment a counter between SEQLOCK_WriteBegin() and SEQLOCK_WriteEnd().
+**
+*/
+static inline void SEQLOCK_IncCnt(uint32 *Cnt)
+{
+
+   __atomic_store_n(Cnt, __atomic_load_n(Cnt, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+
+} /* End SEQLOCK_IncCnt() */
+
+
+/******************************************************************************
+** Function: SEQLOCK_ReadSnapshot
+**
+** Copy a consistent snapshot of a set. Returns false if a consistent
+** snapshot wasn't read after DelayLim delays, in which case Snapshot's
+** contents are undefined.
+**
+*/
+bool SEQLOCK_ReadSnapshot(const uint32 *Seq, const void *Set, void *Snapshot, size_t SetSize, uint32 DelayLim);
+
+
+/******************************************************************************
+** Function: SEQLOCK_Store
+**
+** Store a word between SEQLOCK_WriteBegin() and SEQLOCK_WriteEnd().
+**
+*/
+static inline void SEQLOCK_Store(uint32 *Word, uint32 Value)
+{
+
+   __atomic_store_n(Word, Value, __ATOMIC_RELAXED);
+
+} /* End SEQLOCK_Store() */
+
+
+/******************************************************************************
+** Function: SEQLOCK_WriteBegin
+**
+*/
+static inline void SEQLOCK_WriteBegin(uint32 *Seq)
+{
+
+   __atomic_store_n(Seq, __atomic_load_n(Seq, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+   __atomic_thread_fence(__ATOMIC_RELEASE);
+
+} /* End SEQLOCK_WriteBegin() */
+
+
+/******************************************************************************
+** Function: SEQLOCK_WriteEnd
+**
+*/
+static inline void SEQLOCK_WriteEnd(uint32 *Seq)
+{
+
+   __atomic_store_n(Seq, __atomic_load_n(Seq, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+
+} /* End SEQLOCK_WriteEnd() */
+
+
+#endif /* _seqlock_ */
@@ -0,0 +1,522 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the topic attribute table
+**
+** Notes:
+**   1. The "topic" array has a variable number of entries so core-json
+**      array queries are used rather than a fixed CJSON_Obj_t list.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "cjson.h"
+#include "topic_attr_tbl.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define TOPIC_QUERY_MAX_LEN  40
+#define JSON_INT_MAX_LEN     16
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static bool GetTopicBoolAttr(uint16 Entry, int32 Id, const char *Attr, bool *Value);
+static bool GetTopicIntAttr(uint16 Entry, const char *Attr, int32 *Value);
+static bool GetTopicUint16Attr(uint16 Entry, int32 Id, const char *Attr, uint16 *Value);
+static bool LoadJsonData(size_t JsonFileLen);
+static void SetDefaultAttr(TOPIC_ATTR_TBL_Data_t *Data);
+
+
+/**********************/
+/** Global File Data **/
+/**********************/
+
+static TOPIC_ATTR_TBL_Class_t *TopicAttrTbl = NULL;
+
+static TOPIC_ATTR_TBL_Data_t TblData; /* Working buffer for loads */
+
+static APP_C_FW_TblLoadOptions_Enum_t TblLoadType;
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_Constructor
+**
+*/
+void TOPIC_ATTR_TBL_Constructor(TOPIC_ATTR_TBL_Class_t *TopicAttrTblPtr)
+{
+
+   TopicAttrTbl = TopicAttrTblPtr;
+
+   memset(TopicAttrTbl, 0, sizeof(TOPIC_ATTR_TBL_Class_t));
+
+   SetDefaultAttr(&TopicAttrTbl->Data);
+
+} /* End TOPIC_ATTR_TBL_Constructor() */
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_DumpCmd
+**
+** Notes:
+**  1. TBLMGR opens the file and writes the JSON header so this function writes
+**     the table data and closes the JSON object.
+**  2. Every topic plugin is dumped. TOPIC_ATTR_TBL_JSON_FILE_MAX_CHAR is
+**     sized from the record length so a dumped table can be loaded.
+**
+*/
+bool TOPIC_ATTR_TBL_DumpCmd(osal_id_t FileHandle)
+{
+
+   char DumpRecord[TOPIC_ATTR_TBL_JSON_REC_MAX_CHAR];
+   const TOPIC_ATTR_TBL_Topic_t *Topic;
+
+   sprintf(DumpRecord,"   \"topic\": [\n");
+   OS_write(FileHandle, DumpRecord, strlen(DumpRecord));
+
+   for (uint16 i=0; i < JMSG_APP_TOPIC_PLUGIN_CNT; i++)
+   {
+      Topic = &TopicAttrTbl->Data.Topic[i];
+      snprintf(DumpRecord, sizeof(DumpRecord), "      {\"id\": %d, \"priority\": %d, \"decimation\": %d, \"max-rate\": %d, \"fwd-on-change\": %s, \"keep-alive\": %d, \"encoding\": %d}%s\n",
+              (int)(i + JMSG_PLATFORM_TopicPlugin_Enum_t_MIN), (int)Topic->Priority,
+              Topic->Decimation, Topic->MaxRate,
+              Topic->FwdOnChange ? "true" : "false", Topic->KeepAlive, (int)Topic->Encoding,
+              (i < (JMSG_APP_TOPIC_PLUGIN_CNT-1)) ? "," : "");
+      OS_write(FileHandle, DumpRecord, strlen(DumpRecord));
+   }
+
+   sprintf(DumpRecord,"   ]\n}\n");
+   OS_write(FileHandle, DumpRecord, strlen(DumpRecord));
+
+   return true;
+
+} /* End TOPIC_ATTR_TBL_DumpCmd() */
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_GetEncoding
+**
+*/
+JMSG_APP_TopicEncoding_Enum_t TOPIC_ATTR_TBL_GetEncoding(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   JMSG_APP_TopicEncoding_Enum_t Encoding = TOPIC_ATTR_TBL_DEF_ENCODING;
+
+   if (TopicPlugin >= JMSG_PLATFORM_TopicPlugin_Enum_t_MIN && TopicPlugin <= JMSG_PLATFORM_TopicPlugin_Enum_t_MAX)
+   {
+      Encoding = TopicAttrTbl->Data.Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN].Encoding;
+   }
+
+   return Encoding;
+
+} /* End TOPIC_ATTR_TBL_GetEncoding() */
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_GetTopic
+**
+*/
+const TOPIC_ATTR_TBL_Topic_t *TOPIC_ATTR_TBL_GetTopic(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   const TOPIC_ATTR_TBL_Topic_t *Topic = NULL;
+
+   if (TopicPlugin >= JMSG_PLATFORM_TopicPlugin_Enum_t_MIN && TopicPlugin <= JMSG_PLATFORM_TopicPlugin_Enum_t_MAX)
+   {
+      Topic = &TopicAttrTbl->Data.Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+   }
+
+   return Topic;
+
+} /* End TOPIC_ATTR_TBL_GetTopic() */
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_GetPriority
+**
+*/
+JMSG_APP_TopicPriority_Enum_t TOPIC_ATTR_TBL_GetPriority(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   JMSG_APP_TopicPriority_Enum_t Priority = TOPIC_ATTR_TBL_DEF_PRIORITY;
+
+   if (TopicPlugin >= JMSG_PLATFORM_TopicPlugin_Enum_t_MIN && TopicPlugin <= JMSG_PLATFORM_TopicPlugin_Enum_t_MAX)
+   {
+      Priority = TopicAttrTbl->Data.Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN].Priority;
+   }
+
+   return Priority;
+
+} /* End TOPIC_ATTR_TBL_GetPriority() */
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_LoadCmd
+**
+*/
+bool TOPIC_ATTR_TBL_LoadCmd(APP_C_FW_TblLoadOptions_Enum_t LoadType, const char *Filename)
+{
+
+   bool RetStatus = false;
+
+   TblLoadType = LoadType;
+
+   if (CJSON_ProcessFile(Filename, TopicAttrTbl->JsonBuf, TOPIC_ATTR_TBL_JSON_FILE_MAX_CHAR, LoadJsonData))
+   {
+      TopicAttrTbl->Loaded = true;
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_ATTR_TBL_LoadCmd() */
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_SetEncoding
+**
+*/
+bool TOPIC_ATTR_TBL_SetEncoding(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, JMSG_APP_TopicEncoding_Enum_t Encoding)
+{
+
+   bool RetStatus = false;
+
+   if (TopicPlugin >= JMSG_PLATFORM_TopicPlugin_Enum_t_MIN && TopicPlugin <= JMSG_PLATFORM_TopicPlugin_Enum_t_MAX &&
+       TOPIC_ATTR_TBL_ValidEncoding(Encoding))
+   {
+      TopicAttrTbl->Data.Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN].Encoding = Encoding;
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_ATTR_TBL_SetEncoding() */
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_SetOnChange
+**
+*/
+bool TOPIC_ATTR_TBL_SetOnChange(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, bool FwdOnChange, uint16 KeepAlive)
+{
+
+   bool RetStatus = false;
+   TOPIC_ATTR_TBL_Topic_t *Topic;
+
+   if (TopicPlugin >= JMSG_PLATFORM_TopicPlugin_Enum_t_MIN && TopicPlugin <= JMSG_PLATFORM_TopicPlugin_Enum_t_MAX)
+   {
+      Topic = &TopicAttrTbl->Data.Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+      Topic->FwdOnChange = FwdOnChange;
+      Topic->KeepAlive   = KeepAlive;
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_ATTR_TBL_SetOnChange() */
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_SetRate
+**
+*/
+bool TOPIC_ATTR_TBL_SetRate(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, uint16 Decimation, uint16 MaxRate)
+{
+
+   bool RetStatus = false;
+   TOPIC_ATTR_TBL_Topic_t *Topic;
+
+   if (TopicPlugin >= JMSG_PLATFORM_TopicPlugin_Enum_t_MIN && TopicPlugin <= JMSG_PLATFORM_TopicPlugin_Enum_t_MAX)
+   {
+      Topic = &TopicAttrTbl->Data.Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+      Topic->Decimation = Decimation;
+      Topic->MaxRate    = MaxRate;
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_ATTR_TBL_SetRate() */
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_ValidEncoding
+**
+*/
+bool TOPIC_ATTR_TBL_ValidEncoding(int32 Encoding)
+{
+
+   return (Encoding == JMSG_APP_TopicEncoding_JSON || Encoding == JMSG_APP_TopicEncoding_COMPACT_JSON);
+
+} /* End TOPIC_ATTR_TBL_ValidEncoding() */
+
+
+/******************************************************************************
+** Function: GetTopicBoolAttr
+**
+** Get an optional boolean attribute from a "topic" array entry. Returns false
+** if the attribute is defined and is not a JSON boolean.
+*/
+static bool GetTopicBoolAttr(uint16 Entry, int32 Id, const char *Attr, bool *Value)
+{
+
+   bool        RetStatus = true;
+   char        Query[TOPIC_QUERY_MAX_LEN];
+   char       *ValueStr;
+   size_t      ValueLen;
+   JSONTypes_t ValueType;
+
+   snprintf(Query, sizeof(Query), "topic[%d].%s", Entry, Attr);
+
+   if (JSON_SearchT(TopicAttrTbl->JsonBuf, TopicAttrTbl->JsonFileLen, Query, strlen(Query),
+                    &ValueStr, &ValueLen, &ValueType) == JSONSuccess)
+   {
+      if (ValueType == JSONTrue || ValueType == JSONFalse)
+      {
+         *Value = (ValueType == JSONTrue);
+      }
+      else
+      {
+         EVT_LIM_SendEvent(TOPIC_ATTR_TBL_LOAD_EID, Id, CFE_EVS_EventType_ERROR,
+                           "Topic attribute table load rejected. Topic %d %s must be true or false",
+                           (int)Id, Attr);
+         RetStatus = false;
+      }
+   }
+
+   return RetStatus;
+
+} /* End GetTopicBoolAttr() */
+
+
+/******************************************************************************
+** Function: GetTopicIntAttr
+**
+** Get an integer attribute from a "topic" array entry. Returns false if the
+** attribute is not defined or is not a number.
+*/
+static bool GetTopicIntAttr(uint16 Entry, const char *Attr, int32 *Value)
+{
+
+   bool        RetStatus = false;
+   char        Query[TOPIC_QUERY_MAX_LEN];
+   char        NumStr[JSON_INT_MAX_LEN];
+   char       *ValueStr;
+   size_t      ValueLen;
+   JSONTypes_t ValueType;
+
+   snprintf(Query, sizeof(Query), "topic[%d].%s", Entry, Attr);
+
+   if (JSON_SearchT(TopicAttrTbl->JsonBuf, TopicAttrTbl->JsonFileLen, Query, strlen(Query),
+                    &ValueStr, &ValueLen, &ValueType) == JSONSuccess)
+   {
+      if (ValueType == JSONNumber && ValueLen < sizeof(NumStr))
+      {
+         memcpy(NumStr, ValueStr, ValueLen);
+         NumStr[ValueLen] = '\0';
+         *Value = (int32)strtol(NumStr, NULL, 10);
+         RetStatus = true;
+      }
+   }
+
+   return RetStatus;
+
+} /* End GetTopicIntAttr() */
+
+
+/******************************************************************************
+** Function: GetTopicUint16Attr
+**
+** Get an optional uint16 attribute from a "topic" array entry. Returns false
+** if the attribute is defined and out of range.
+*/
+static bool GetTopicUint16Attr(uint16 Entry, int32 Id, const char *Attr, uint16 *Value)
+{
+
+   bool  RetStatus = true;
+   int32 IntValue;
+
+   if (GetTopicIntAttr(Entry, Attr, &IntValue))
+   {
+      if (IntValue >= 0 && IntValue <= UINT16_MAX)
+      {
+         *Value = (uint16)IntValue;
+      }
+      else
+      {
+         EVT_LIM_SendEvent(TOPIC_ATTR_TBL_LOAD_EID, Id, CFE_EVS_EventType_ERROR,
+                           "Topic attribute table load rejected. Topic %d has invalid %s %d",
+                           (int)Id, Attr, (int)IntValue);
+         RetStatus = false;
+      }
+   }
+
+   return RetStatus;
+
+} /* End GetTopicUint16Attr() */
+
+
+/******************************************************************************
+** Function: LoadJsonData
+**
+** Notes:
+**  1. A REPLACE load starts from default attributes so unlisted topics are
+**     reset. Any other load type starts from the current attributes so only
+**     the listed topics are changed.
+**  2. The entire load is rejected if any topic entry is invalid, if a topic
+**     ID is listed more than once, or if there are more entries than topic
+**     plugins.
+*/
+static bool LoadJsonData(size_t JsonFileLen)
+{
+
+   bool    RetStatus = true;
+   uint16  EntryCnt  = 0;
+   int32   Id;
+   int32   Priority;
+   int32   Encoding;
+   bool    Listed[JMSG_APP_TOPIC_PLUGIN_CNT];
+   TOPIC_ATTR_TBL_Topic_t *Topic;
+
+   TopicAttrTbl->JsonFileLen = JsonFileLen;
+
+   /*
+   ** 1. Copy table owner data into local table buffer
+   ** 2. Process JSON file which updates local table buffer with JSON supplied values
+   ** 3. If valid, copy local buffer over owner's data
+   */
+
+   if (TblLoadType == APP_C_FW_TblLoadOptions_REPLACE)
+   {
+      SetDefaultAttr(&TblData);
+   }
+   else
+   {
+      memcpy(&TblData, &TopicAttrTbl->Data, sizeof(TOPIC_ATTR_TBL_Data_t));
+   }
+
+   memset(Listed, 0, sizeof(Listed));
+
+   while (RetStatus && EntryCnt < JMSG_APP_TOPIC_PLUGIN_CNT && GetTopicIntAttr(EntryCnt, "id", &Id))
+   {
+      if (Id < JMSG_PLATFORM_TopicPlugin_Enum_t_MIN || Id > JMSG_PLATFORM_TopicPlugin_Enum_t_MAX)
+      {
+         EVT_LIM_SendEvent(TOPIC_ATTR_TBL_LOAD_EID, Id, CFE_EVS_EventType_ERROR,
+                           "Topic attribute table load rejected. Entry %d has invalid topic plugin ID %d",
+                           EntryCnt, (int)Id);
+         RetStatus = false;
+         break;
+      }
+
+      if (Listed[Id - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN])
+      {
+         EVT_LIM_SendEvent(TOPIC_ATTR_TBL_LOAD_EID, Id, CFE_EVS_EventType_ERROR,
+                           "Topic attribute table load rejected. Entry %d duplicates topic plugin ID %d",
+                           EntryCnt, (int)Id);
+         RetStatus = false;
+         break;
+      }
+      Listed[Id - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN] = true;
+
+      Topic = &TblData.Topic[Id - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+
+      if (GetTopicIntAttr(EntryCnt, "priority", &Priority))
+      {
+         if (Priority < JMSG_APP_TopicPriority_Enum_t_MIN || Priority > JMSG_APP_TopicPriority_Enum_t_MAX)
+         {
+            EVT_LIM_SendEvent(TOPIC_ATTR_TBL_LOAD_EID, Id, CFE_EVS_EventType_ERROR,
+                              "Topic attribute table load rejected. Topic %d has invalid priority %d",
+                              (int)Id, (int)Priority);
+            RetStatus = false;
+            break;
+         }
+         Topic->Priority = (JMSG_APP_TopicPriority_Enum_t)Priority;
+      }
+
+      if (GetTopicIntAttr(EntryCnt, "encoding", &Encoding))
+      {
+         if (!TOPIC_ATTR_TBL_ValidEncoding(Encoding))
+         {
+            EVT_LIM_SendEvent(TOPIC_ATTR_TBL_LOAD_EID, Id, CFE_EVS_EventType_ERROR,
+                              "Topic attribute table load rejected. Topic %d has invalid encoding %d",
+                              (int)Id, (int)Encoding);
+            RetStatus = false;
+            break;
+         }
+         Topic->Encoding = (JMSG_APP_TopicEncoding_Enum_t)Encoding;
+      }
+
+      if (!GetTopicUint16Attr(EntryCnt, Id, "decimation", &Topic->Decimation) ||
+          !GetTopicUint16Attr(EntryCnt, Id, "max-rate", &Topic->MaxRate)      ||
+          !GetTopicBoolAttr(EntryCnt, Id, "fwd-on-change", &Topic->FwdOnChange) ||
+          !GetTopicUint16Attr(EntryCnt, Id, "keep-alive", &Topic->KeepAlive))
+      {
+         RetStatus = false;
+         break;
+      }
+
+      EntryCnt++;
+
+   } /* End topic entry loop */
+
+   if (RetStatus && EntryCnt == JMSG_APP_TOPIC_PLUGIN_CNT && GetTopicIntAttr(EntryCnt, "id", &Id))
+   {
+      EVT_LIM_SendEvent(TOPIC_ATTR_TBL_LOAD_EID, EVT_LIM_NO_TOPIC, CFE_EVS_EventType_ERROR,
+                        "Topic attribute table load rejected. More than %d topic entries defined",
+                        JMSG_APP_TOPIC_PLUGIN_CNT);
+      RetStatus = false;
+   }
+
+   if (RetStatus)
+   {
+      memcpy(&TopicAttrTbl->Data, &TblData, sizeof(TOPIC_ATTR_TBL_Data_t));
+      TopicAttrTbl->LastLoadCnt = EntryCnt;
+      CFE_EVS_SendEvent(TOPIC_ATTR_TBL_LOAD_EID, CFE_EVS_EventType_INFORMATION,
+                        "Topic attribute table loaded %d topic entries", EntryCnt);
+   }
+
+   return RetStatus;
+
+} /* End LoadJsonData() */
+
+
+/******************************************************************************
+** Function: SetDefaultAttr
+**
+*/
+static void SetDefaultAttr(TOPIC_ATTR_TBL_Data_t *Data)
+{
+
+   for (uint16 i=0; i < JMSG_APP_TOPIC_PLUGIN_CNT; i++)
+   {
+      Data->Topic[i].Priority    = TOPIC_ATTR_TBL_DEF_PRIORITY;
+      Data->Topic[i].Decimation  = TOPIC_ATTR_TBL_DEF_DECIMATION;
+      Data->Topic[i].MaxRate     = TOPIC_ATTR_TBL_DEF_MAX_RATE;
+      Data->Topic[i].FwdOnChange = TOPIC_ATTR_TBL_DEF_ON_CHANGE;
+      Data->Topic[i].KeepAlive   = TOPIC_ATTR_TBL_DEF_KEEP_ALIVE;
+      Data->Topic[i].Encoding    = TOPIC_ATTR_TBL_DEF_ENCODING;
+   }
+
+} /* End SetDefaultAttr() */
@@ -0,0 +1,237 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Manage JMSG_APP's topic attribute table
+**
+** Notes:
+**   1. JMSG_LIB owns the topic table that defines each topic plugin. This
+**      table is owned by JMSG_APP and defines attributes that control how
+**      JMSG_APP manages each topic plugin.
+**   2. Topic plugins that are not listed in the table are assigned default
+**      attribute values.
+**   3. The JSON table has a "topic" array and each array entry must contain
+**      an "id" that is a JMSG_PLATFORM_TopicPlugin value.
+**   4. Attributes may be changed by commands so a table dump contains the
+**      current runtime attributes.
+**
+*/
+
+#ifndef _topic_attr_tbl_
+#define _topic_attr_tbl_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "evt_lim.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define TOPIC_ATTR_TBL_NAME                "Topic Attributes"
+#define TOPIC_ATTR_TBL_JSON_HDR_MAX_CHAR   1024  /* Table file header written by TBLMGR and the closing brackets */
+#define TOPIC_ATTR_TBL_JSON_REC_MAX_CHAR   160   /* One dumped topic record                                      */
+#define TOPIC_ATTR_TBL_JSON_FILE_MAX_CHAR  (TOPIC_ATTR_TBL_JSON_HDR_MAX_CHAR + JMSG_APP_TOPIC_PLUGIN_CNT*TOPIC_ATTR_TBL_JSON_REC_MAX_CHAR)
+
+#define TOPIC_ATTR_TBL_DEF_PRIORITY    JMSG_APP_TopicPriority_NORMAL
+#define TOPIC_ATTR_TBL_DEF_DECIMATION  1   /* Forward every message      */
+#define TOPIC_ATTR_TBL_DEF_MAX_RATE    0   /* No message rate limit      */
+#define TOPIC_ATTR_TBL_DEF_ON_CHANGE   false
+#define TOPIC_ATTR_TBL_DEF_KEEP_ALIVE  0
+#define TOPIC_ATTR_TBL_DEF_ENCODING    JMSG_APP_TopicEncoding_JSON
+
+/*
+** Event Message IDs
+*/
+
+#define TOPIC_ATTR_TBL_LOAD_EID  (TOPIC_ATTR_TBL_BASE_EID + 0)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Table - Local table copy used for table loads
+**
+*/
+
+typedef struct
+{
+
+   JMSG_APP_TopicPriority_Enum_t  Priority;
+   uint16  Decimation;  /* Forward every Nth SB message, 0 & 1 forward every message */
+   uint16  MaxRate;     /* Maximum SB messages forwarded per second, 0 is unlimited  */
+   bool    FwdOnChange; /* Only forward SB messages with a changed payload           */
+   uint16  KeepAlive;   /* Seconds before an unchanged payload is forwarded, 0 never */
+   JMSG_APP_TopicEncoding_Enum_t  Encoding;
+
+} TOPIC_ATTR_TBL_Topic_t;
+
+
+typedef struct
+{
+
+   TOPIC_ATTR_TBL_Topic_t  Topic[JMSG_APP_TOPIC_PLUGIN_CNT];
+
+} TOPIC_ATTR_TBL_Data_t;
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   /*
+   ** Table Data
+   */
+
+   TOPIC_ATTR_TBL_Data_t  Data;
+
+   /*
+   ** Standard CJSON table data
+   */
+
+   bool    Loaded;
+   uint16  LastLoadCnt;
+
+   size_t  JsonFileLen;
+   char    JsonBuf[TOPIC_ATTR_TBL_JSON_FILE_MAX_CHAR];
+
+} TOPIC_ATTR_TBL_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_Constructor
+**
+** Initialize the topic attribute table object.
+**
+** Notes:
+**   1. This must be called prior to any other function.
+**   2. All topics are assigned default attributes until a table is loaded.
+**
+*/
+void TOPIC_ATTR_TBL_Constructor(TOPIC_ATTR_TBL_Class_t *TopicAttrTblPtr);
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_DumpCmd
+**
+** Command to write the table data from memory to a JSON file.
+**
+** Notes:
+**  1. Function signature must match TBLMGR_DumpTblFuncPtr_t.
+**  2. File is formatted so it can be used as a load file.
+**
+*/
+bool TOPIC_ATTR_TBL_DumpCmd(osal_id_t FileHandle);
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_GetEncoding
+**
+** Return the network encoding of a topic plugin's messages. Invalid topic
+** plugin IDs return the default encoding.
+**
+*/
+JMSG_APP_TopicEncoding_Enum_t TOPIC_ATTR_TBL_GetEncoding(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_GetTopic
+**
+** Return a pointer to a topic plugin's attributes or NULL if the topic plugin
+** ID is invalid.
+**
+*/
+const TOPIC_ATTR_TBL_Topic_t *TOPIC_ATTR_TBL_GetTopic(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_GetPriority
+**
+** Return the subscription broadcast priority of a topic plugin. Invalid topic
+** plugin IDs return the default priority.
+**
+*/
+JMSG_APP_TopicPriority_Enum_t TOPIC_ATTR_TBL_GetPriority(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_LoadCmd
+**
+** Command to load the table.
+**
+** Notes:
+**  1. Function signature must match TBLMGR_LoadTblFuncPtr_t.
+**  2. A replace load resets topics that are not in the file to their default
+**     attributes. An update load only changes the topics that are in the file.
+**
+*/
+bool TOPIC_ATTR_TBL_LoadCmd(APP_C_FW_TblLoadOptions_Enum_t LoadType, const char *Filename);
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_SetEncoding
+**
+** Set the network encoding of a topic plugin's messages. Returns false if the
+** topic plugin ID or the encoding is invalid.
+**
+*/
+bool TOPIC_ATTR_TBL_SetEncoding(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, JMSG_APP_TopicEncoding_Enum_t Encoding);
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_SetOnChange
+**
+** Set a topic plugin's forward on change mode and keep-alive period. Returns
+** false if the topic plugin ID is invalid.
+**
+*/
+bool TOPIC_ATTR_TBL_SetOnChange(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, bool FwdOnChange, uint16 KeepAlive);
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_SetRate
+**
+** Set a topic plugin's SB message forwarding decimation factor and rate limit.
+** Returns false if the topic plugin ID is invalid.
+**
+*/
+bool TOPIC_ATTR_TBL_SetRate(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, uint16 Decimation, uint16 MaxRate);
+
+
+/******************************************************************************
+** Function: TOPIC_ATTR_TBL_ValidEncoding
+**
+** Return true if an encoding can be assigned to a topic. KEEP is only
+** meaningful in the ConfigTopicPlugin command. CBOR is rejected because
+** JMSG_LIB's CfeToJson interface can only return JSON text. See topic_enc.h.
+**
+*/
+bool TOPIC_ATTR_TBL_ValidEncoding(int32 Encoding);
+
+
+#endif /* _topic_attr_tbl_ */
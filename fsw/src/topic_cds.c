@@ -0,0 +1,260 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the TOPIC_CDS class
+**
+** Notes:
+**   None
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "jmsg_topic_tbl.h"
+#include "topic_attr_tbl.h"
+#include "topic_cds.h"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static uint16 CheckTopicDefs(void);
+static uint32 TopicDefCrc(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static TOPIC_CDS_Class_t *TopicCds;
+
+
+/******************************************************************************
+** Function: TOPIC_CDS_Constructor
+**
+** Notes:
+**   1. A CDS block saved with different topic plugin definitions or a
+**      different partition is ignored and overwritten.
+**
+*/
+void TOPIC_CDS_Constructor(TOPIC_CDS_Class_t *TopicCdsPtr, const INITBL_Class_t *IniTbl)
+{
+
+   CFE_Status_t Status;
+   uint16 ChangedDefCnt = 0;
+
+   TopicCds = TopicCdsPtr;
+
+   memset((void*)TopicCds, 0, sizeof(TOPIC_CDS_Class_t));
+
+   TopicCds->SavePeriod = INITBL_GetIntConfig(IniTbl, CFG_CDS_SAVE_PERIOD);
+
+   if (TopicCds->SavePeriod == 0)
+   {
+      return;
+   }
+
+   Status = CFE_ES_RegisterCDS(&TopicCds->Handle, sizeof(TOPIC_CDS_Data_t), TOPIC_CDS_NAME);
+
+   if (Status == CFE_ES_CDS_ALREADY_EXISTS)
+   {
+
+      TopicCds->Created = true;
+
+      Status = CFE_ES_RestoreFromCDS(&TopicCds->Data, TopicCds->Handle);
+
+      if (Status == CFE_SUCCESS &&
+          TopicCds->Data.TopicCnt   == JMSG_APP_TOPIC_PLUGIN_CNT &&
+          TopicCds->Data.FirstTopic == TOPIC_PART_First() &&
+          TopicCds->Data.LastTopic  == TOPIC_PART_Last())
+      {
+         ChangedDefCnt = CheckTopicDefs();
+         TopicCds->Restored = (ChangedDefCnt == 0);
+      }
+
+      if (!TopicCds->Restored)
+      {
+         CFE_EVS_SendEvent(TOPIC_CDS_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                           "Topic plugin state not restored from CDS. Restore status 0x%08X, saved partition %d..%d, %d changed topic definitions",
+                           (unsigned int)Status, TopicCds->Data.FirstTopic, TopicCds->Data.LastTopic, ChangedDefCnt);
+      }
+
+   }
+   else if (Status == CFE_SUCCESS)
+   {
+      TopicCds->Created = true;
+   }
+   else
+   {
+      CFE_EVS_SendEvent(TOPIC_CDS_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Error registering topic plugin state CDS block, status 0x%08X", (unsigned int)Status);
+   }
+
+} /* End TOPIC_CDS_Constructor() */
+
+
+/******************************************************************************
+** Function: TOPIC_CDS_GetTopic
+**
+*/
+const TOPIC_CDS_Topic_t *TOPIC_CDS_GetTopic(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   const TOPIC_CDS_Topic_t *Topic = NULL;
+
+   if (TopicCds->Restored && TOPIC_PART_Contains(TopicPlugin))
+   {
+      Topic = &TopicCds->Data.Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+   }
+
+   return Topic;
+
+} /* End TOPIC_CDS_GetTopic() */
+
+
+/******************************************************************************
+** Function: TOPIC_CDS_Restored
+**
+*/
+bool TOPIC_CDS_Restored(void)
+{
+
+   return TopicCds->Restored;
+
+} /* End TOPIC_CDS_Restored() */
+
+
+/******************************************************************************
+** Function: TOPIC_CDS_Run
+**
+*/
+void TOPIC_CDS_Run(void)
+{
+
+   if (TopicCds->Created && ++TopicCds->WakeupCnt >= TopicCds->SavePeriod)
+   {
+      TOPIC_CDS_Save();
+   }
+
+} /* End TOPIC_CDS_Run() */
+
+
+/******************************************************************************
+** Function: TOPIC_CDS_Save
+**
+** Notes:
+**   1. Only the first of consecutive save errors is reported.
+**
+*/
+void TOPIC_CDS_Save(void)
+{
+
+   CFE_Status_t Status;
+   TOPIC_CDS_Topic_t *CdsTopic;
+   const JMSG_TOPIC_TBL_Topic_t *Topic;
+   const TOPIC_ATTR_TBL_Topic_t *TopicAttr;
+
+   if (!TopicCds->Created)
+   {
+      return;
+   }
+
+   TopicCds->WakeupCnt = 0;
+
+   TopicCds->Data.TopicCnt   = JMSG_APP_TOPIC_PLUGIN_CNT;
+   TopicCds->Data.FirstTopic = TOPIC_PART_First();
+   TopicCds->Data.LastTopic  = TOPIC_PART_Last();
+
+   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); i <= TOPIC_PART_Last(); i++)
+   {
+
+      CdsTopic  = &TopicCds->Data.Topic[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+      Topic     = JMSG_TOPIC_TBL_GetTopic(i);
+      TopicAttr = TOPIC_ATTR_TBL_GetTopic(i);
+
+      CdsTopic->Enabled  = (Topic != NULL && Topic->Enabled);
+      CdsTopic->Encoding = (TopicAttr != NULL) ? TopicAttr->Encoding : 0;
+      CdsTopic->DefCrc   = TopicDefCrc(i);
+      TOPIC_FWD_GetTopicStats(i, &CdsTopic->FwdStats);
+
+   }
+
+   Status = CFE_ES_CopyToCDS(TopicCds->Handle, &TopicCds->Data);
+
+   if (Status != CFE_SUCCESS && !TopicCds->SaveErr)
+   {
+      CFE_EVS_SendEvent(TOPIC_CDS_SAVE_EID, CFE_EVS_EventType_ERROR,
+                        "Error saving topic plugin state in CDS, status 0x%08X", (unsigned int)Status);
+   }
+   TopicCds->SaveErr = (Status != CFE_SUCCESS);
+
+} /* End TOPIC_CDS_Save() */
+
+
+/******************************************************************************
+** Function: CheckTopicDefs
+**
+** Return the number of partition topics whose definition differs from the
+** definition saved in the CDS block.
+**
+*/
+static uint16 CheckTopicDefs(void)
+{
+
+   uint16 ChangedCnt = 0;
+
+   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); i <= TOPIC_PART_Last(); i++)
+   {
+      if (TopicCds->Data.Topic[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN].DefCrc != TopicDefCrc(i))
+      {
+         ChangedCnt++;
+      }
+   }
+
+   return ChangedCnt;
+
+} /* End CheckTopicDefs() */
+
+
+/******************************************************************************
+** Function: TopicDefCrc
+**
+** Return the CRC of a topic's name, message ID and protocol. An undefined
+** topic's CRC is 0.
+**
+*/
+static uint32 TopicDefCrc(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   uint32 Crc = 0;
+   uint32 Value;
+   const JMSG_TOPIC_TBL_Topic_t *Topic = JMSG_TOPIC_TBL_GetTopic(TopicPlugin);
+
+   if (Topic != NULL)
+   {
+      Crc   = CFE_ES_CalculateCRC(Topic->Name, strlen(Topic->Name), Crc, CFE_MISSION_ES_DEFAULT_CRC);
+      Value = Topic->Cfe;
+      Crc   = CFE_ES_CalculateCRC(&Value, sizeof(Value), Crc, CFE_MISSION_ES_DEFAULT_CRC);
+      Value = JMSG_TOPIC_TBL_GetTopicProtocol(TopicPlugin);
+      Crc   = CFE_ES_CalculateCRC(&Value, sizeof(Value), Crc, CFE_MISSION_ES_DEFAULT_CRC);
+   }
+
+   return Crc;
+
+} /* End TopicDefCrc() */
@@ -0,0 +1,172 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Preserve the topic plugin state in the Critical Data Store
+**
+** Notes:
+**   1. Each topic plugin's enabled state, network encoding and forwarding
+**      statistics are saved in a CDS block every CDS_SAVE_PERIOD wakeups
+**      and after a topic plugin is enabled or disabled.
+**   2. The CDS block exists after a processor reset or an app restart. If
+**      its contents are valid and were saved with the same partition and
+**      topic definitions the state is restored by
+**      JMSG_LIB_MGR_Constructor(). Each topic's definition is checked with
+**      a CRC of its name, message ID and protocol. After an app
+**      restart only the changed topics are announced. After a processor
+**      reset all topics are broadcast because the JMSG protocol apps were
+**      also restarted. A CDS_SAVE_PERIOD of 0 disables the CDS.
+**   3. The CDS block is registered with the instance's cFE app name so
+**      multiple JMSG_APP instances have their own blocks.
+**
+*/
+
+#ifndef _topic_cds_
+#define _topic_cds_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "topic_part.h"
+#include "topic_fwd.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define TOPIC_CDS_NAME  "TopicState"
+
+/*
+** Event Message IDs
+*/
+
+#define TOPIC_CDS_CONSTRUCTOR_EID  (TOPIC_CDS_BASE_EID + 0)
+#define TOPIC_CDS_SAVE_EID         (TOPIC_CDS_BASE_EID + 1)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Saved state for one topic plugin
+*/
+
+typedef struct
+{
+
+   bool    Enabled;
+   uint8   Encoding;
+   uint16  Spare;
+   uint32  DefCrc;    /* CRC of the topic's name, message ID and protocol */
+   TOPIC_FWD_Stats_t  FwdStats;
+
+} TOPIC_CDS_Topic_t;
+
+
+/******************************************************************************
+** CDS block contents
+*/
+
+typedef struct
+{
+
+   uint32  TopicCnt;     /* Detects a change to the topic plugin definitions */
+   uint16  FirstTopic;
+   uint16  LastTopic;
+   TOPIC_CDS_Topic_t  Topic[JMSG_APP_TOPIC_PLUGIN_CNT];
+
+} TOPIC_CDS_Data_t;
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   uint16  SavePeriod;
+   uint16  WakeupCnt;
+
+   bool    Created;
+   bool    Restored;
+   bool    SaveErr;
+   CFE_ES_CDSHandle_t  Handle;
+
+   TOPIC_CDS_Data_t  Data;
+
+} TOPIC_CDS_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TOPIC_CDS_Constructor
+**
+** Register the CDS block and read its contents if it already exists.
+**
+** Notes:
+**   1. Must be called after the JMSG topic table is loaded so the saved
+**      topic definitions can be checked.
+**
+*/
+void TOPIC_CDS_Constructor(TOPIC_CDS_Class_t *TopicCdsPtr, const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: TOPIC_CDS_GetTopic
+**
+** Return a topic plugin's restored state or NULL if the state wasn't
+** restored.
+**
+*/
+const TOPIC_CDS_Topic_t *TOPIC_CDS_GetTopic(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_CDS_Restored
+**
+** Return true if the topic plugin state was restored from the CDS.
+**
+*/
+bool TOPIC_CDS_Restored(void);
+
+
+/******************************************************************************
+** Function: TOPIC_CDS_Run
+**
+** Save the topic plugin state every CDS_SAVE_PERIOD wakeups. Must be called
+** once per wakeup.
+**
+*/
+void TOPIC_CDS_Run(void);
+
+
+/******************************************************************************
+** Function: TOPIC_CDS_Save
+**
+** Save the topic plugin state in the CDS.
+**
+*/
+void TOPIC_CDS_Save(void);
+
+
+#endif /* _topic_cds_ */
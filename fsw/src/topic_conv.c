@@ -0,0 +1,692 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the EDS generated converter support functions
+**
+** Notes:
+**   1. Reader values returned by NextValue() include their delimiters so
+**      strings start with '"' and objects with '{' for both the in-order
+**      and keyed search paths.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "cjson.h"
+#include "topic_conv.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define NUM_STR_MAX_LEN  32
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static bool   EnterContainer(TOPIC_CONV_Reader_t *Parent, const char *Key, TOPIC_CONV_Reader_t *Child, char Open);
+static bool   GetNumStr(TOPIC_CONV_Reader_t *Reader, const char *Key, char *NumStr);
+static bool   NextKey(const char *Json, size_t JsonLen, size_t *Pos, const char **Key, size_t *KeyLen);
+static bool   NextValue(TOPIC_CONV_Reader_t *Reader, const char *Key, const char **Value, size_t *ValueLen);
+static size_t SkipWhitespace(const char *Json, size_t JsonLen, size_t Pos);
+static size_t ValueEnd(const char *Json, size_t JsonLen, size_t Pos);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_Append
+**
+*/
+void TOPIC_CONV_Append(TOPIC_CONV_Writer_t *Writer, const char *Format, ...)
+{
+
+   va_list Args;
+   int     Len;
+
+   if (Writer->Len < Writer->BufSize)
+   {
+      va_start(Args, Format);
+      Len = vsnprintf(&Writer->Buf[Writer->Len], Writer->BufSize - Writer->Len, Format, Args);
+      va_end(Args);
+
+      if (Len < 0 || (size_t)Len >= (Writer->BufSize - Writer->Len))
+      {
+         Writer->Len = Writer->BufSize;
+      }
+      else
+      {
+         Writer->Len += Len;
+      }
+   }
+
+} /* End TOPIC_CONV_Append() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_EnterArray
+**
+*/
+bool TOPIC_CONV_EnterArray(TOPIC_CONV_Reader_t *Parent, const char *Key, TOPIC_CONV_Reader_t *Child)
+{
+
+   return EnterContainer(Parent, Key, Child, '[');
+
+} /* End TOPIC_CONV_EnterArray() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_EnterObj
+**
+*/
+bool TOPIC_CONV_EnterObj(TOPIC_CONV_Reader_t *Parent, const char *Key, TOPIC_CONV_Reader_t *Child)
+{
+
+   return EnterContainer(Parent, Key, Child, '{');
+
+} /* End TOPIC_CONV_EnterObj() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_GetDouble
+**
+*/
+bool TOPIC_CONV_GetDouble(TOPIC_CONV_Reader_t *Reader, const char *Key, double *Value)
+{
+
+   bool RetStatus = false;
+   char NumStr[NUM_STR_MAX_LEN];
+   char *NumEnd;
+
+   if (GetNumStr(Reader, Key, NumStr))
+   {
+      *Value = strtod(NumStr, &NumEnd);
+      RetStatus = (*NumEnd == '\0');
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_CONV_GetDouble() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_GetInt
+**
+*/
+bool TOPIC_CONV_GetInt(TOPIC_CONV_Reader_t *Reader, const char *Key, long long *Value)
+{
+
+   bool RetStatus = false;
+   char NumStr[NUM_STR_MAX_LEN];
+   char *NumEnd;
+
+   if (GetNumStr(Reader, Key, NumStr))
+   {
+      *Value = strtoll(NumStr, &NumEnd, 10);
+      RetStatus = (*NumEnd == '\0');
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_CONV_GetInt() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_GetString
+**
+** Notes:
+**   1. \u escapes outside of the ASCII range are replaced with '?'. EDS
+**      strings are file names and identifiers.
+*/
+bool TOPIC_CONV_GetString(TOPIC_CONV_Reader_t *Reader, const char *Key, char *Str, size_t StrSize)
+{
+
+   const char *Value;
+   size_t ValueLen;
+   size_t StrLen = 0;
+   char   Char;
+   char   HexStr[5];
+   long   CodePoint;
+
+   if (!NextValue(Reader, Key, &Value, &ValueLen) || Value[0] != '"' || ValueLen < 2)
+   {
+      return false;
+   }
+
+   for (size_t i=1; i < (ValueLen - 1); i++)
+   {
+      Char = Value[i];
+      if (Char == '\\' && (i + 1) < (ValueLen - 1))
+      {
+         switch (Value[++i])
+         {
+            case 'b': Char = '\b'; break;
+            case 'f': Char = '\f'; break;
+            case 'n': Char = '\n'; break;
+            case 'r': Char = '\r'; break;
+            case 't': Char = '\t'; break;
+            case 'u':
+               if ((i + 4) >= (ValueLen - 1))
+               {
+                  return false;
+               }
+               memcpy(HexStr, &Value[i+1], 4);
+               HexStr[4] = '\0';
+               CodePoint = strtol(HexStr, NULL, 16);
+               Char = (CodePoint < 0x80) ? (char)CodePoint : '?';
+               i += 4;
+               break;
+            default:  Char = Value[i]; break;
+         }
+      }
+      if (StrLen >= (StrSize - 1))
+      {
+         return false;
+      }
+      Str[StrLen++] = Char;
+   }
+
+   Str[StrLen] = '\0';
+
+   return true;
+
+} /* End TOPIC_CONV_GetString() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_GetTopicConv
+**
+*/
+const TOPIC_CONV_Conv_t *TOPIC_CONV_GetTopicConv(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   const TOPIC_CONV_Conv_t *Conv;
+
+   for (Conv = TOPIC_CONV_ConvTbl; Conv->Name != NULL; Conv++)
+   {
+      if (Conv->TopicPlugin == (int32)TopicPlugin)
+      {
+         return Conv;
+      }
+   }
+
+   return NULL;
+
+} /* End TOPIC_CONV_GetTopicConv() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_GetUint
+**
+*/
+bool TOPIC_CONV_GetUint(TOPIC_CONV_Reader_t *Reader, const char *Key, unsigned long long *Value)
+{
+
+   bool RetStatus = false;
+   char NumStr[NUM_STR_MAX_LEN];
+   char *NumEnd;
+
+   if (GetNumStr(Reader, Key, NumStr) && NumStr[0] != '-')
+   {
+      *Value = strtoull(NumStr, &NumEnd, 10);
+      RetStatus = (*NumEnd == '\0');
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_CONV_GetUint() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_PutDouble
+**
+*/
+void TOPIC_CONV_PutDouble(TOPIC_CONV_Writer_t *Writer, double Value, int Precision)
+{
+
+   if (isfinite(Value))
+   {
+      TOPIC_CONV_Append(Writer, "%.*g", Precision, Value);
+   }
+   else
+   {
+      TOPIC_CONV_Append(Writer, "null");
+   }
+
+} /* End TOPIC_CONV_PutDouble() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_PutString
+**
+*/
+void TOPIC_CONV_PutString(TOPIC_CONV_Writer_t *Writer, const char *Str, size_t MaxLen)
+{
+
+   char Char;
+
+   TOPIC_CONV_Append(Writer, "\"");
+
+   for (size_t i=0; i < MaxLen && Str[i] != '\0' && Writer->Len < Writer->BufSize; i++)
+   {
+      Char = Str[i];
+      if (Char == '"' || Char == '\\')
+      {
+         TOPIC_CONV_Append(Writer, "\\%c", Char);
+      }
+      else if ((unsigned char)Char < 0x20)
+      {
+         TOPIC_CONV_Append(Writer, "\\u%04x", (unsigned int)Char);
+      }
+      else if ((Writer->Len + 1) < Writer->BufSize)
+      {
+         Writer->Buf[Writer->Len++] = Char;
+         Writer->Buf[Writer->Len]   = '\0';
+      }
+      else
+      {
+         Writer->Len = Writer->BufSize;
+      }
+   }
+
+   TOPIC_CONV_Append(Writer, "\"");
+
+} /* End TOPIC_CONV_PutString() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_ReaderInit
+**
+*/
+bool TOPIC_CONV_ReaderInit(TOPIC_CONV_Reader_t *Reader, const char *Json, size_t JsonLen)
+{
+
+   bool   RetStatus = false;
+   size_t Start = SkipWhitespace(Json, JsonLen, 0);
+   size_t End;
+
+   memset(Reader, 0, sizeof(TOPIC_CONV_Reader_t));
+
+   if (Start < JsonLen && Json[Start] == '{')
+   {
+      End = ValueEnd(Json, JsonLen, Start);
+      if (End > Start)
+      {
+         Reader->Json    = &Json[Start];
+         Reader->JsonLen = End - Start;
+         Reader->Pos     = 1;
+         RetStatus = true;
+      }
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_CONV_ReaderInit() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_SameKeys
+**
+*/
+bool TOPIC_CONV_SameKeys(const char *Json1, const char *Json2)
+{
+
+   size_t Json1Len = strlen(Json1);
+   size_t Json2Len = strlen(Json2);
+   size_t Pos1 = 0;
+   size_t Pos2 = 0;
+   const char *Key1, *Key2;
+   size_t Key1Len, Key2Len;
+   bool   Found1, Found2;
+
+   do
+   {
+
+      Found1 = NextKey(Json1, Json1Len, &Pos1, &Key1, &Key1Len);
+      Found2 = NextKey(Json2, Json2Len, &Pos2, &Key2, &Key2Len);
+
+      if (Found1 != Found2 ||
+          (Found1 && (Key1Len != Key2Len || memcmp(Key1, Key2, Key1Len) != 0)))
+      {
+         return false;
+      }
+
+   } while (Found1);
+
+   return true;
+
+} /* End TOPIC_CONV_SameKeys() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_WriterEnd
+**
+*/
+size_t TOPIC_CONV_WriterEnd(const TOPIC_CONV_Writer_t *Writer)
+{
+
+   return (Writer->Len < Writer->BufSize) ? Writer->Len : 0;
+
+} /* End TOPIC_CONV_WriterEnd() */
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_WriterInit
+**
+*/
+void TOPIC_CONV_WriterInit(TOPIC_CONV_Writer_t *Writer, char *Buf, size_t BufSize)
+{
+
+   Writer->Buf     = Buf;
+   Writer->BufSize = BufSize;
+   Writer->Len     = 0;
+
+   if (BufSize > 0)
+   {
+      Buf[0] = '\0';
+   }
+
+} /* End TOPIC_CONV_WriterInit() */
+
+
+/******************************************************************************
+** Function: EnterContainer
+**
+*/
+static bool EnterContainer(TOPIC_CONV_Reader_t *Parent, const char *Key, TOPIC_CONV_Reader_t *Child, char Open)
+{
+
+   bool RetStatus = false;
+   const char *Value;
+   size_t ValueLen;
+
+   if (NextValue(Parent, Key, &Value, &ValueLen) && Value[0] == Open)
+   {
+      memset(Child, 0, sizeof(TOPIC_CONV_Reader_t));
+      Child->Json    = Value;
+      Child->JsonLen = ValueLen;
+      Child->Pos     = 1;
+      Child->IsArray = (Open == '[');
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End EnterContainer() */
+
+
+/******************************************************************************
+** Function: GetNumStr
+**
+** Copy a JSON number into a null terminated string.
+*/
+static bool GetNumStr(TOPIC_CONV_Reader_t *Reader, const char *Key, char *NumStr)
+{
+
+   bool RetStatus = false;
+   const char *Value;
+   size_t ValueLen;
+
+   if (NextValue(Reader, Key, &Value, &ValueLen))
+   {
+      if (ValueLen > 0 && ValueLen < NUM_STR_MAX_LEN &&
+          (Value[0] == '-' || (Value[0] >= '0' && Value[0] <= '9')))
+      {
+         memcpy(NumStr, Value, ValueLen);
+         NumStr[ValueLen] = '\0';
+         RetStatus = true;
+      }
+   }
+
+   return RetStatus;
+
+} /* End GetNumStr() */
+
+
+/******************************************************************************
+** Function: NextKey
+**
+** Find the next object member name at any depth starting at Pos. A member
+** name is a string followed by a colon. Key points to the name's text
+** without the quotes. Pos is set to the position following the string.
+*/
+static bool NextKey(const char *Json, size_t JsonLen, size_t *Pos, const char **Key, size_t *KeyLen)
+{
+
+   size_t Start;
+   size_t i = *Pos;
+
+   while (i < JsonLen)
+   {
+
+      if (Json[i++] != '"')
+      {
+         continue;
+      }
+
+      Start = i;
+      while (i < JsonLen && Json[i] != '"')
+      {
+         i += (Json[i] == '\\') ? 2 : 1;
+      }
+      if (i >= JsonLen)
+      {
+         break;
+      }
+
+      *KeyLen = i - Start;
+      i = SkipWhitespace(Json, JsonLen, i + 1);
+      if (i < JsonLen && Json[i] == ':')
+      {
+         *Key = &Json[Start];
+         *Pos = i + 1;
+         return true;
+      }
+
+   } /* End character loop */
+
+   *Pos = JsonLen;
+
+   return false;
+
+} /* End NextKey() */
+
+
+/******************************************************************************
+** Function: NextValue
+**
+** Get the value of an object member or the next array element.
+**
+** Notes:
+**   1. An object member at the reader's position is consumed. Otherwise the
+**      member is found using a keyed search and the position isn't changed
+**      so the following members can still be read in order.
+*/
+static bool NextValue(TOPIC_CONV_Reader_t *Reader, const char *Key, const char **Value, size_t *ValueLen)
+{
+
+   const char *Json = Reader->Json;
+   size_t JsonLen   = Reader->JsonLen;
+   size_t Pos       = SkipWhitespace(Json, JsonLen, Reader->Pos);
+   size_t KeyLen;
+   size_t End;
+   char  *SearchValue;
+   JSONTypes_t ValueType;
+
+   if (Pos < JsonLen && Json[Pos] == ',')
+   {
+      Pos = SkipWhitespace(Json, JsonLen, Pos + 1);
+   }
+
+   if (!Reader->IsArray)
+   {
+
+      if (Key == NULL)
+      {
+         return false;
+      }
+
+      KeyLen = strlen(Key);
+
+      if ((Pos + KeyLen + 2) < JsonLen && Json[Pos] == '"' &&
+          strncmp(&Json[Pos+1], Key, KeyLen) == 0 && Json[Pos+1+KeyLen] == '"')
+      {
+         Pos = SkipWhitespace(Json, JsonLen, Pos + KeyLen + 2);
+         if (Pos < JsonLen && Json[Pos] == ':')
+         {
+            Pos = SkipWhitespace(Json, JsonLen, Pos + 1);
+            End = ValueEnd(Json, JsonLen, Pos);
+            if (End > Pos)
+            {
+               *Value    = &Json[Pos];
+               *ValueLen = End - Pos;
+               Reader->Pos = End;
+               return true;
+            }
+         }
+         return false;
+      }
+
+      if (JSON_SearchT((char *)Json, JsonLen, Key, KeyLen, &SearchValue, ValueLen, &ValueType) != JSONSuccess)
+      {
+         return false;
+      }
+
+      if (ValueType == JSONString)
+      {
+         /* Include the quotes that core-json excludes */
+         SearchValue--;
+         *ValueLen += 2;
+      }
+      *Value = SearchValue;
+
+   }
+   else
+   {
+
+      End = ValueEnd(Json, JsonLen, Pos);
+      if (Key != NULL || End <= Pos)
+      {
+         return false;
+      }
+
+      *Value    = &Json[Pos];
+      *ValueLen = End - Pos;
+      Reader->Pos = End;
+
+   }
+
+   return true;
+
+} /* End NextValue() */
+
+
+/******************************************************************************
+** Function: SkipWhitespace
+**
+*/
+static size_t SkipWhitespace(const char *Json, size_t JsonLen, size_t Pos)
+{
+
+   while (Pos < JsonLen && (Json[Pos] == ' ' || Json[Pos] == '\t' || Json[Pos] == '\n' || Json[Pos] == '\r'))
+   {
+      Pos++;
+   }
+
+   return Pos;
+
+} /* End SkipWhitespace() */
+
+
+/******************************************************************************
+** Function: ValueEnd
+**
+** Return the position following the JSON value that starts at Pos or Pos if
+** there isn't a complete value. Closing brackets end objects and arrays so a
+** closing bracket at Pos isn't a value.
+*/
+static size_t ValueEnd(const char *Json, size_t JsonLen, size_t Pos)
+{
+
+   size_t End   = Pos;
+   int    Depth = 0;
+   bool   InString = false;
+   char   Char;
+
+   if (Pos >= JsonLen || Json[Pos] == '}' || Json[Pos] == ']')
+   {
+      return Pos;
+   }
+
+   while (End < JsonLen)
+   {
+
+      Char = Json[End];
+
+      if (InString)
+      {
+         if (Char == '\\')
+         {
+            End++;
+         }
+         else if (Char == '"')
+         {
+            InString = false;
+            if (Depth == 0)
+            {
+               return End + 1;
+            }
+         }
+      }
+      else if (Char == '"')
+      {
+         InString = true;
+      }
+      else if (Char == '{' || Char == '[')
+      {
+         Depth++;
+      }
+      else if (Char == '}' || Char == ']')
+      {
+         if (Depth == 0)
+         {
+            return End;  /* End of a scalar that is the last member */
+         }
+         if (--Depth == 0)
+         {
+            return End + 1;
+         }
+      }
+      else if (Depth == 0 && (Char == ',' || Char == ' ' || Char == '\t' || Char == '\n' || Char == '\r'))
+      {
+         return End;
+      }
+
+      End++;
+
+   } /* End character loop */
+
+   /* A scalar can end at the end of the text */
+   return (Depth == 0 && !InString) ? End : Pos;
+
+} /* End ValueEnd() */
@@ -0,0 +1,308 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Support EDS generated JSON<->SB payload converters
+**
+** Notes:
+**   1. tools/topic_conv_gen.py generates a ToJson and a FromJson function
+**      for each EDS payload container listed in the CMake variable
+**      JMSG_APP_TOPIC_CONV_SPECS. The generated code calls the writer and
+**      reader functions defined here. Only ToJson is used in flight. JMSG
+**      protocol apps convert received JSON messages with the topic plugin's
+**      JsonToCfe function. FromJson is used by the benchmark.
+**   2. ToJson functions are straight-line code. Each run of scalar fields
+**      is written with a single format string.
+**   3. FromJson functions read members in the order ToJson writes them so
+**      each member is parsed once. A member that isn't at the reader's
+**      position is found with a keyed JSON search so JSON from other
+**      sources is still accepted.
+**   4. A converter assigned to a topic plugin replaces the topic plugin's
+**      CfeToJson conversion. TOPIC_HOOK gets it with TOPIC_CONV_GetTopicConv()
+**      and writes the JSON to the converter's JsonBuf. Only the protocol app
+**      that sends the topic writes JsonBuf. The converter's JSON member
+**      names are the EDS entry names so TOPIC_HOOK checks them against the
+**      topic plugin's JSON with TOPIC_CONV_SameKeys() before using it.
+**   5. These functions don't use any global data so they can be called
+**      from any task.
+**   6. This file and the generated converters are only built when
+**      JMSG_APP_TOPIC_CONV_SPECS isn't empty. The build then defines
+**      JMSG_APP_TOPIC_CONV.
+**
+*/
+
+#ifndef _topic_conv_
+#define _topic_conv_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define TOPIC_CONV_NO_TOPIC  (-1)  /* Converter isn't assigned to a topic plugin */
+
+/*
+** Read a JSON member into a payload field. Integer assignments are read back
+** so values that don't fit in the field are rejected without the generated
+** code knowing the field's size.
+*/
+
+#define TOPIC_CONV_GET_UINT(ReaderPtr, Key, Field) \
+   (TOPIC_CONV_GetUint(ReaderPtr, Key, &(ReaderPtr)->Uint) && (((Field) = (ReaderPtr)->Uint) == (ReaderPtr)->Uint))
+
+#define TOPIC_CONV_GET_INT(ReaderPtr, Key, Field) \
+   (TOPIC_CONV_GetInt(ReaderPtr, Key, &(ReaderPtr)->Int) && (((Field) = (ReaderPtr)->Int) == (ReaderPtr)->Int))
+
+#define TOPIC_CONV_GET_DOUBLE(ReaderPtr, Key, Field) \
+   (TOPIC_CONV_GetDouble(ReaderPtr, Key, &(ReaderPtr)->Dbl) && (((Field) = (ReaderPtr)->Dbl), true))
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** JSON writer used by ToJson functions
+*/
+
+typedef struct
+{
+
+   char   *Buf;
+   size_t  BufSize;
+   size_t  Len;       /* Set to BufSize when the buffer overflows */
+
+} TOPIC_CONV_Writer_t;
+
+
+/******************************************************************************
+** JSON object or array reader used by FromJson functions
+*/
+
+typedef struct
+{
+
+   const char *Json;     /* Object or array text starting with '{' or '[' */
+   size_t      JsonLen;  /* Length through the closing '}' or ']'         */
+   size_t      Pos;      /* Position of the next member or element         */
+   bool        IsArray;
+
+   /* Values are returned here by the TOPIC_CONV_GET_xxx macros */
+   unsigned long long Uint;
+   long long          Int;
+   double             Dbl;
+
+} TOPIC_CONV_Reader_t;
+
+
+/******************************************************************************
+** Generated converter
+*/
+
+typedef size_t (*TOPIC_CONV_ToJson_t)(const void *Payload, char *JsonBuf, size_t JsonBufSize);
+typedef bool   (*TOPIC_CONV_FromJson_t)(const char *Json, size_t JsonLen, void *Payload);
+
+typedef struct
+{
+
+   int32                  TopicPlugin;  /* JMSG_PLATFORM_TopicPlugin_Enum_t or TOPIC_CONV_NO_TOPIC */
+   const char            *Name;         /* EDS PKG/Container */
+   size_t                 PayloadSize;
+   TOPIC_CONV_ToJson_t    ToJson;
+   TOPIC_CONV_FromJson_t  FromJson;
+   char                  *JsonBuf;      /* JMSG_APP_TOPIC_CONV_JSON_MAX_LEN bytes, NULL if TOPIC_CONV_NO_TOPIC */
+
+} TOPIC_CONV_Conv_t;
+
+extern const TOPIC_CONV_Conv_t TOPIC_CONV_ConvTbl[];  /* Generated, terminated by a NULL Name */
+
+
+#ifdef TOPIC_CONV_BENCH
+
+/******************************************************************************
+** Field descriptors used by the benchmark's keyed runtime converter
+*/
+
+typedef enum
+{
+
+   TOPIC_CONV_BENCH_UINT,
+   TOPIC_CONV_BENCH_INT,
+   TOPIC_CONV_BENCH_ENUM,
+   TOPIC_CONV_BENCH_FLOAT,
+   TOPIC_CONV_BENCH_DOUBLE,
+   TOPIC_CONV_BENCH_STRING
+
+} TOPIC_CONV_BenchKind_t;
+
+typedef struct
+{
+
+   const char             *Name;
+   TOPIC_CONV_BenchKind_t  Kind;
+   size_t                  Offset;
+   size_t                  Size;
+
+} TOPIC_CONV_BenchField_t;
+
+typedef struct
+{
+
+   const char                    *Name;
+   const TOPIC_CONV_BenchField_t *Fields;  /* NULL if the container isn't flat */
+
+} TOPIC_CONV_BenchConv_t;
+
+extern const TOPIC_CONV_BenchConv_t TOPIC_CONV_BenchTbl[];  /* Generated, parallel to TOPIC_CONV_ConvTbl */
+
+#endif /* TOPIC_CONV_BENCH */
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_Append
+**
+** Append printf formatted text to a JSON writer.
+**
+*/
+void TOPIC_CONV_Append(TOPIC_CONV_Writer_t *Writer, const char *Format, ...);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_EnterArray
+**
+** Start reading the array that is a member of Parent (Key != NULL) or the
+** next element of a Parent array (Key == NULL).
+**
+*/
+bool TOPIC_CONV_EnterArray(TOPIC_CONV_Reader_t *Parent, const char *Key, TOPIC_CONV_Reader_t *Child);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_EnterObj
+**
+** Start reading the object that is a member of Parent (Key != NULL) or the
+** next element of a Parent array (Key == NULL).
+**
+*/
+bool TOPIC_CONV_EnterObj(TOPIC_CONV_Reader_t *Parent, const char *Key, TOPIC_CONV_Reader_t *Child);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_GetDouble
+**
+*/
+bool TOPIC_CONV_GetDouble(TOPIC_CONV_Reader_t *Reader, const char *Key, double *Value);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_GetInt
+**
+*/
+bool TOPIC_CONV_GetInt(TOPIC_CONV_Reader_t *Reader, const char *Key, long long *Value);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_GetString
+**
+** Unescape a JSON string into a null terminated string. Returns false if the
+** string doesn't fit in StrSize.
+**
+*/
+bool TOPIC_CONV_GetString(TOPIC_CONV_Reader_t *Reader, const char *Key, char *Str, size_t StrSize);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_GetTopicConv
+**
+** Return a topic plugin's generated converter or NULL if the topic plugin
+** doesn't have one.
+**
+*/
+const TOPIC_CONV_Conv_t *TOPIC_CONV_GetTopicConv(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_GetUint
+**
+*/
+bool TOPIC_CONV_GetUint(TOPIC_CONV_Reader_t *Reader, const char *Key, unsigned long long *Value);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_PutDouble
+**
+** Append a JSON number. Infinity and NaN are written as null.
+**
+*/
+void TOPIC_CONV_PutDouble(TOPIC_CONV_Writer_t *Writer, double Value, int Precision);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_PutString
+**
+** Append a quoted and escaped JSON string from a character array that may
+** not be null terminated.
+**
+*/
+void TOPIC_CONV_PutString(TOPIC_CONV_Writer_t *Writer, const char *Str, size_t MaxLen);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_ReaderInit
+**
+** Start reading a JSON object. Returns false if Json doesn't contain an
+** object.
+**
+*/
+bool TOPIC_CONV_ReaderInit(TOPIC_CONV_Reader_t *Reader, const char *Json, size_t JsonLen);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_SameKeys
+**
+** Return true if two JSON texts have the same object member names in the
+** same order at every depth. Values aren't compared.
+**
+*/
+bool TOPIC_CONV_SameKeys(const char *Json1, const char *Json2);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_WriterEnd
+**
+** Return the JSON text length or 0 if the buffer overflowed.
+**
+*/
+size_t TOPIC_CONV_WriterEnd(const TOPIC_CONV_Writer_t *Writer);
+
+
+/******************************************************************************
+** Function: TOPIC_CONV_WriterInit
+**
+*/
+void TOPIC_CONV_WriterInit(TOPIC_CONV_Writer_t *Writer, char *Buf, size_t BufSize);
+
+
+#endif /* _topic_conv_ */
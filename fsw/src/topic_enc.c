@@ -0,0 +1,1102 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement topic message encoding
+**
+** Notes:
+**   1. The JSON parser rejects text it can't convert but it is not a strict
+**      JSON validator. Topic plugin JSON is assumed to be well formed.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "topic_enc.h"
+#include "topic_attr_tbl.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/* CBOR major types */
+#define CBOR_UINT     0
+#define CBOR_NINT     1
+#define CBOR_BSTR     2
+#define CBOR_TSTR     3
+#define CBOR_ARRAY    4
+#define CBOR_MAP      5
+#define CBOR_TAG      6
+#define CBOR_SIMPLE   7
+
+/* CBOR additional information values */
+#define CBOR_AI_1BYTE       24
+#define CBOR_AI_2BYTE       25
+#define CBOR_AI_4BYTE       26
+#define CBOR_AI_8BYTE       27
+#define CBOR_AI_INDEFINITE  31
+
+#define CBOR_FALSE      0xF4
+#define CBOR_TRUE       0xF5
+#define CBOR_NULL       0xF6
+#define CBOR_UNDEFINED  0xF7
+#define CBOR_DOUBLE     0xFB
+#define CBOR_BREAK      0xFF
+
+#define NUM_STR_MAX_LEN  32
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+typedef struct
+{
+
+   const char *Json;
+   size_t      JsonLen;
+   size_t      Pos;
+
+   uint8      *Buf;
+   size_t      BufSize;
+   size_t      Len;
+
+   bool        Error;
+
+} JsonToCbor_t;
+
+
+typedef struct
+{
+
+   const uint8 *Cbor;
+   size_t       CborLen;
+   size_t       Pos;
+
+   char        *Buf;
+   size_t       BufSize;
+   size_t       Len;
+
+   bool         Error;
+
+} CborToJson_t;
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void   CborPutByte(JsonToCbor_t *Enc, uint8 Byte);
+static void   CborPutHead(JsonToCbor_t *Enc, uint8 MajorType, uint64 Arg);
+static bool   JsonMatchLiteral(const JsonToCbor_t *Enc, const char *Literal);
+static void   JsonParseNumber(JsonToCbor_t *Enc);
+static void   JsonParseString(JsonToCbor_t *Enc);
+static void   JsonParseValue(JsonToCbor_t *Enc, uint16 Depth);
+static bool   JsonParseHex4(JsonToCbor_t *Enc, size_t Pos, uint32 *CodePoint);
+static void   JsonSkipWhitespace(JsonToCbor_t *Enc);
+static size_t Utf8Encode(uint32 CodePoint, uint8 *Utf8);
+
+static bool   CborGetArg(CborToJson_t *Dec, uint8 AddInfo, uint64 *Arg);
+static void   CborParseItem(CborToJson_t *Dec, uint16 Depth);
+static void   JsonPutChar(CborToJson_t *Dec, char Char);
+static void   JsonPutStr(CborToJson_t *Dec, const char *Str);
+static void   JsonPutString(CborToJson_t *Dec, const uint8 *Str, size_t StrLen);
+static double HalfToDouble(uint16 Half);
+
+
+/******************************************************************************
+** Function: TOPIC_ENC_CborToJson
+**
+*/
+size_t TOPIC_ENC_CborToJson(const uint8 *Cbor, size_t CborLen, char *JsonBuf, size_t JsonBufSize)
+{
+
+   CborToJson_t Dec;
+
+   memset(&Dec, 0, sizeof(CborToJson_t));
+   Dec.Cbor    = Cbor;
+   Dec.CborLen = CborLen;
+   Dec.Buf     = JsonBuf;
+   Dec.BufSize = JsonBufSize;
+
+   CborParseItem(&Dec, 0);
+   JsonPutChar(&Dec, '\0');
+
+   if (Dec.Error || Dec.Pos != Dec.CborLen)
+   {
+      return 0;
+   }
+
+   return (Dec.Len - 1);
+
+} /* End TOPIC_ENC_CborToJson() */
+
+
+/******************************************************************************
+** Function: TOPIC_ENC_CompactJson
+**
+*/
+size_t TOPIC_ENC_CompactJson(const char *Json, size_t JsonLen, char *JsonBuf, size_t JsonBufSize)
+{
+
+   size_t Len      = 0;
+   bool   InString = false;
+   bool   Escaped  = false;
+   char   Char;
+
+   for (size_t i=0; i < JsonLen && Json[i] != '\0'; i++)
+   {
+
+      Char = Json[i];
+
+      if (InString)
+      {
+         if (Escaped)
+         {
+            Escaped = false;
+         }
+         else if (Char == '\\')
+         {
+            Escaped = true;
+         }
+         else if (Char == '"')
+         {
+            InString = false;
+         }
+      }
+      else if (Char == ' ' || Char == '\t' || Char == '\n' || Char == '\r')
+      {
+         continue;
+      }
+      else if (Char == '"')
+      {
+         InString = true;
+      }
+
+      if (Len >= (JsonBufSize - 1))
+      {
+         return 0;
+      }
+      JsonBuf[Len++] = Char;
+
+   } /* End JSON character loop */
+
+   JsonBuf[Len] = '\0';
+
+   return Len;
+
+} /* End TOPIC_ENC_CompactJson() */
+
+
+/******************************************************************************
+** Function: TOPIC_ENC_DecodeMsg
+**
+*/
+size_t TOPIC_ENC_DecodeMsg(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const uint8 *Msg, size_t MsgLen,
+                           char *JsonBuf, size_t JsonBufSize, const char **JsonMsg)
+{
+
+   size_t JsonLen = 0;
+
+   if (TOPIC_ATTR_TBL_GetEncoding(TopicPlugin) == JMSG_APP_TopicEncoding_CBOR)
+   {
+      JsonLen  = TOPIC_ENC_CborToJson(Msg, MsgLen, JsonBuf, JsonBufSize);
+      *JsonMsg = JsonBuf;
+   }
+   else
+   {
+      /* Compact JSON is valid JSON so it doesn't need to be decoded */
+      JsonLen  = MsgLen;
+      *JsonMsg = (const char *)Msg;
+   }
+
+   return JsonLen;
+
+} /* End TOPIC_ENC_DecodeMsg() */
+
+
+/******************************************************************************
+** Function: TOPIC_ENC_EncodeMsg
+**
+*/
+size_t TOPIC_ENC_EncodeMsg(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const char *Json, size_t JsonLen,
+                           uint8 *Buf, size_t BufSize, const uint8 **EncodedMsg)
+{
+
+   size_t EncodedLen = 0;
+
+   switch (TOPIC_ATTR_TBL_GetEncoding(TopicPlugin))
+   {
+      case JMSG_APP_TopicEncoding_COMPACT_JSON:
+         EncodedLen  = TOPIC_ENC_CompactJson(Json, JsonLen, (char *)Buf, BufSize);
+         *EncodedMsg = Buf;
+         break;
+
+      case JMSG_APP_TopicEncoding_CBOR:
+         EncodedLen  = TOPIC_ENC_JsonToCbor(Json, JsonLen, Buf, BufSize);
+         *EncodedMsg = Buf;
+         break;
+
+      default:
+         EncodedLen  = JsonLen;
+         *EncodedMsg = (const uint8 *)Json;
+         break;
+
+   } /* End encoding switch */
+
+   return EncodedLen;
+
+} /* End TOPIC_ENC_EncodeMsg() */
+
+
+/******************************************************************************
+** Function: TOPIC_ENC_JsonToCbor
+**
+*/
+size_t TOPIC_ENC_JsonToCbor(const char *Json, size_t JsonLen, uint8 *CborBuf, size_t CborBufSize)
+{
+
+   JsonToCbor_t Enc;
+
+   memset(&Enc, 0, sizeof(JsonToCbor_t));
+   Enc.Json    = Json;
+   while (JsonLen > 0 && Json[JsonLen-1] == '\0')
+   {
+      JsonLen--;  /* Allow the length to include the null terminator */
+   }
+   Enc.JsonLen = JsonLen;
+   Enc.Buf     = CborBuf;
+   Enc.BufSize = CborBufSize;
+
+   JsonParseValue(&Enc, 0);
+   JsonSkipWhitespace(&Enc);
+
+   if (Enc.Error || Enc.Pos != Enc.JsonLen)
+   {
+      return 0;
+   }
+
+   return Enc.Len;
+
+} /* End TOPIC_ENC_JsonToCbor() */
+
+
+/******************************************************************************
+** Function: CborPutByte
+**
+*/
+static void CborPutByte(JsonToCbor_t *Enc, uint8 Byte)
+{
+
+   if (Enc->Len < Enc->BufSize)
+   {
+      Enc->Buf[Enc->Len++] = Byte;
+   }
+   else
+   {
+      Enc->Error = true;
+   }
+
+} /* End CborPutByte() */
+
+
+/******************************************************************************
+** Function: CborPutHead
+**
+** Write a CBOR data item head using the shortest argument encoding.
+*/
+static void CborPutHead(JsonToCbor_t *Enc, uint8 MajorType, uint64 Arg)
+{
+
+   uint8 ArgBytes;
+
+   MajorType <<= 5;
+
+   if (Arg < CBOR_AI_1BYTE)
+   {
+      CborPutByte(Enc, MajorType | (uint8)Arg);
+      ArgBytes = 0;
+   }
+   else if (Arg <= 0xFF)
+   {
+      CborPutByte(Enc, MajorType | CBOR_AI_1BYTE);
+      ArgBytes = 1;
+   }
+   else if (Arg <= 0xFFFF)
+   {
+      CborPutByte(Enc, MajorType | CBOR_AI_2BYTE);
+      ArgBytes = 2;
+   }
+   else if (Arg <= 0xFFFFFFFF)
+   {
+      CborPutByte(Enc, MajorType | CBOR_AI_4BYTE);
+      ArgBytes = 4;
+   }
+   else
+   {
+      CborPutByte(Enc, MajorType | CBOR_AI_8BYTE);
+      ArgBytes = 8;
+   }
+
+   while (ArgBytes > 0)
+   {
+      ArgBytes--;
+      CborPutByte(Enc, (uint8)(Arg >> (8*ArgBytes)));
+   }
+
+} /* End CborPutHead() */
+
+
+/******************************************************************************
+** Function: JsonMatchLiteral
+**
+** Return true if a JSON literal starts at Pos. Only the remaining JSON is
+** compared because the JSON isn't required to be null terminated.
+*/
+static bool JsonMatchLiteral(const JsonToCbor_t *Enc, const char *Literal)
+{
+
+   size_t LiteralLen = strlen(Literal);
+
+   return (LiteralLen <= (Enc->JsonLen - Enc->Pos) &&
+           memcmp(&Enc->Json[Enc->Pos], Literal, LiteralLen) == 0);
+
+} /* End JsonMatchLiteral() */
+
+
+/******************************************************************************
+** Function: JsonParseHex4
+**
+** Parse the four hex digits of a \u escape sequence starting at Pos.
+*/
+static bool JsonParseHex4(JsonToCbor_t *Enc, size_t Pos, uint32 *CodePoint)
+{
+
+   char Char;
+
+   if ((Pos + 4) > Enc->JsonLen)
+   {
+      return false;
+   }
+
+   *CodePoint = 0;
+   for (size_t i=Pos; i < (Pos + 4); i++)
+   {
+      Char = Enc->Json[i];
+      *CodePoint <<= 4;
+      if (Char >= '0' && Char <= '9')
+      {
+         *CodePoint |= (uint32)(Char - '0');
+      }
+      else if (Char >= 'a' && Char <= 'f')
+      {
+         *CodePoint |= (uint32)(Char - 'a' + 10);
+      }
+      else if (Char >= 'A' && Char <= 'F')
+      {
+         *CodePoint |= (uint32)(Char - 'A' + 10);
+      }
+      else
+      {
+         return false;
+      }
+   }
+
+   return true;
+
+} /* End JsonParseHex4() */
+
+
+/******************************************************************************
+** Function: JsonParseNumber
+**
+*/
+static void JsonParseNumber(JsonToCbor_t *Enc)
+{
+
+   char   NumStr[NUM_STR_MAX_LEN];
+   char  *NumEnd;
+   size_t NumLen  = 0;
+   bool   IsFloat = false;
+   char   Char;
+   int64  IntValue;
+   double DblValue;
+   uint64 DblBits;
+
+   while (Enc->Pos < Enc->JsonLen)
+   {
+      Char = Enc->Json[Enc->Pos];
+      if (Char == '.' || Char == 'e' || Char == 'E')
+      {
+         IsFloat = true;
+      }
+      else if (!((Char >= '0' && Char <= '9') || Char == '-' || Char == '+'))
+      {
+         break;
+      }
+      if (NumLen >= (sizeof(NumStr) - 1))
+      {
+         Enc->Error = true;
+         return;
+      }
+      NumStr[NumLen++] = Char;
+      Enc->Pos++;
+   }
+   NumStr[NumLen] = '\0';
+
+   if (!IsFloat)
+   {
+      IntValue = strtoll(NumStr, &NumEnd, 10);
+      if (NumLen > 0 && *NumEnd == '\0' && IntValue > INT64_MIN && IntValue < INT64_MAX)
+      {
+         if (IntValue >= 0)
+         {
+            CborPutHead(Enc, CBOR_UINT, (uint64)IntValue);
+         }
+         else
+         {
+            CborPutHead(Enc, CBOR_NINT, (uint64)(-1 - IntValue));
+         }
+         return;
+      }
+      /* Integers that don't fit in 64 bits are encoded as floats */
+   }
+
+   DblValue = strtod(NumStr, &NumEnd);
+   if (NumLen == 0 || *NumEnd != '\0')
+   {
+      Enc->Error = true;
+      return;
+   }
+
+   memcpy(&DblBits, &DblValue, sizeof(DblBits));
+   CborPutByte(Enc, CBOR_DOUBLE);
+   for (int i=7; i >= 0; i--)
+   {
+      CborPutByte(Enc, (uint8)(DblBits >> (8*i)));
+   }
+
+} /* End JsonParseNumber() */
+
+
+/******************************************************************************
+** Function: JsonParseString
+**
+** Notes:
+**   1. The string is scanned twice. The first pass computes the unescaped
+**      length for the CBOR head and the second pass writes the UTF-8 text.
+*/
+static void JsonParseString(JsonToCbor_t *Enc)
+{
+
+   uint8  Utf8[4];
+   size_t Utf8Len;
+   uint32 CodePoint;
+   uint32 LowSurrogate;
+   size_t StrLen;
+   size_t Pos;
+   char   Char;
+   bool   WriteStr = false;
+
+   Enc->Pos++;  /* Skip opening quote */
+
+   for (int Pass=0; Pass < 2; Pass++)
+   {
+
+      StrLen = 0;
+      Pos    = Enc->Pos;
+
+      while (true)
+      {
+         if (Pos >= Enc->JsonLen)
+         {
+            Enc->Error = true;
+            return;
+         }
+
+         Char = Enc->Json[Pos++];
+
+         if (Char == '"')
+         {
+            break;
+         }
+         else if (Char == '\\')
+         {
+            if (Pos >= Enc->JsonLen)
+            {
+               Enc->Error = true;
+               return;
+            }
+            Char = Enc->Json[Pos++];
+            Utf8Len = 1;
+            switch (Char)
+            {
+               case '"':
+               case '\\':
+               case '/':  Utf8[0] = (uint8)Char; break;
+               case 'b':  Utf8[0] = '\b'; break;
+               case 'f':  Utf8[0] = '\f'; break;
+               case 'n':  Utf8[0] = '\n'; break;
+               case 'r':  Utf8[0] = '\r'; break;
+               case 't':  Utf8[0] = '\t'; break;
+               case 'u':
+                  if (!JsonParseHex4(Enc, Pos, &CodePoint))
+                  {
+                     Enc->Error = true;
+                     return;
+                  }
+                  Pos += 4;
+                  if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF &&
+                      (Pos + 6) <= Enc->JsonLen && Enc->Json[Pos] == '\\' && Enc->Json[Pos+1] == 'u' &&
+                      JsonParseHex4(Enc, Pos+2, &LowSurrogate) && LowSurrogate >= 0xDC00 && LowSurrogate <= 0xDFFF)
+                  {
+                     CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+                     Pos += 6;
+                  }
+                  Utf8Len = Utf8Encode(CodePoint, Utf8);
+                  break;
+               default:
+                  Enc->Error = true;
+                  return;
+            }
+         }
+         else
+         {
+            Utf8[0] = (uint8)Char;
+            Utf8Len = 1;
+         }
+
+         if (WriteStr)
+         {
+            for (size_t i=0; i < Utf8Len; i++)
+            {
+               CborPutByte(Enc, Utf8[i]);
+            }
+         }
+         StrLen += Utf8Len;
+
+      } /* End string character loop */
+
+      if (!WriteStr)
+      {
+         CborPutHead(Enc, CBOR_TSTR, StrLen);
+         WriteStr = true;
+      }
+
+   } /* End pass loop */
+
+   Enc->Pos = Pos;
+
+} /* End JsonParseString() */
+
+
+/******************************************************************************
+** Function: JsonParseValue
+**
+*/
+static void JsonParseValue(JsonToCbor_t *Enc, uint16 Depth)
+{
+
+   char   Char;
+   bool   First;
+   char   EndChar;
+
+   JsonSkipWhitespace(Enc);
+
+   if (Enc->Pos >= Enc->JsonLen || Depth > TOPIC_ENC_MAX_DEPTH)
+   {
+      Enc->Error = true;
+      return;
+   }
+
+   Char = Enc->Json[Enc->Pos];
+
+   if (Char == '{' || Char == '[')
+   {
+
+      EndChar = (Char == '{') ? '}' : ']';
+      CborPutByte(Enc, (uint8)((((Char == '{') ? CBOR_MAP : CBOR_ARRAY) << 5) | CBOR_AI_INDEFINITE));
+      Enc->Pos++;
+      First = true;
+
+      while (!Enc->Error)
+      {
+         JsonSkipWhitespace(Enc);
+         if (Enc->Pos >= Enc->JsonLen)
+         {
+            Enc->Error = true;
+            break;
+         }
+         if (Enc->Json[Enc->Pos] == EndChar)
+         {
+            Enc->Pos++;
+            CborPutByte(Enc, CBOR_BREAK);
+            break;
+         }
+         if (!First)
+         {
+            if (Enc->Json[Enc->Pos] != ',')
+            {
+               Enc->Error = true;
+               break;
+            }
+            Enc->Pos++;
+            JsonSkipWhitespace(Enc);
+         }
+         First = false;
+
+         if (EndChar == '}')
+         {
+            if (Enc->Pos >= Enc->JsonLen || Enc->Json[Enc->Pos] != '"')
+            {
+               Enc->Error = true;
+               break;
+            }
+            JsonParseString(Enc);
+            JsonSkipWhitespace(Enc);
+            if (Enc->Pos >= Enc->JsonLen || Enc->Json[Enc->Pos] != ':')
+            {
+               Enc->Error = true;
+               break;
+            }
+            Enc->Pos++;
+         }
+
+         JsonParseValue(Enc, Depth + 1);
+
+      } /* End member loop */
+   }
+   else if (Char == '"')
+   {
+      JsonParseString(Enc);
+   }
+   else if (JsonMatchLiteral(Enc, "true"))
+   {
+      CborPutByte(Enc, CBOR_TRUE);
+      Enc->Pos += 4;
+   }
+   else if (JsonMatchLiteral(Enc, "false"))
+   {
+      CborPutByte(Enc, CBOR_FALSE);
+      Enc->Pos += 5;
+   }
+   else if (JsonMatchLiteral(Enc, "null"))
+   {
+      CborPutByte(Enc, CBOR_NULL);
+      Enc->Pos += 4;
+   }
+   else if (Char == '-' || (Char >= '0' && Char <= '9'))
+   {
+      JsonParseNumber(Enc);
+   }
+   else
+   {
+      Enc->Error = true;
+   }
+
+} /* End JsonParseValue() */
+
+
+/******************************************************************************
+** Function: JsonSkipWhitespace
+**
+*/
+static void JsonSkipWhitespace(JsonToCbor_t *Enc)
+{
+
+   char Char;
+
+   while (Enc->Pos < Enc->JsonLen)
+   {
+      Char = Enc->Json[Enc->Pos];
+      if (Char != ' ' && Char != '\t' && Char != '\n' && Char != '\r')
+      {
+         break;
+      }
+      Enc->Pos++;
+   }
+
+} /* End JsonSkipWhitespace() */
+
+
+/******************************************************************************
+** Function: Utf8Encode
+**
+*/
+static size_t Utf8Encode(uint32 CodePoint, uint8 *Utf8)
+{
+
+   size_t Len;
+
+   if (CodePoint < 0x80)
+   {
+      Utf8[0] = (uint8)CodePoint;
+      Len = 1;
+   }
+   else if (CodePoint < 0x800)
+   {
+      Utf8[0] = (uint8)(0xC0 | (CodePoint >> 6));
+      Utf8[1] = (uint8)(0x80 | (CodePoint & 0x3F));
+      Len = 2;
+   }
+   else if (CodePoint < 0x10000)
+   {
+      Utf8[0] = (uint8)(0xE0 | (CodePoint >> 12));
+      Utf8[1] = (uint8)(0x80 | ((CodePoint >> 6) & 0x3F));
+      Utf8[2] = (uint8)(0x80 | (CodePoint & 0x3F));
+      Len = 3;
+   }
+   else
+   {
+      Utf8[0] = (uint8)(0xF0 | (CodePoint >> 18));
+      Utf8[1] = (uint8)(0x80 | ((CodePoint >> 12) & 0x3F));
+      Utf8[2] = (uint8)(0x80 | ((CodePoint >> 6) & 0x3F));
+      Utf8[3] = (uint8)(0x80 | (CodePoint & 0x3F));
+      Len = 4;
+   }
+
+   return Len;
+
+} /* End Utf8Encode() */
+
+
+/******************************************************************************
+** Function: CborGetArg
+**
+** Get a data item head's argument. Indefinite lengths are not returned as
+** arguments and must be handled by the caller.
+*/
+static bool CborGetArg(CborToJson_t *Dec, uint8 AddInfo, uint64 *Arg)
+{
+
+   uint8 ArgBytes;
+
+   if (AddInfo < CBOR_AI_1BYTE)
+   {
+      *Arg = AddInfo;
+      return true;
+   }
+
+   switch (AddInfo)
+   {
+      case CBOR_AI_1BYTE: ArgBytes = 1; break;
+      case CBOR_AI_2BYTE: ArgBytes = 2; break;
+      case CBOR_AI_4BYTE: ArgBytes = 4; break;
+      case CBOR_AI_8BYTE: ArgBytes = 8; break;
+      default:
+         return false;
+   }
+
+   if (ArgBytes > (Dec->CborLen - Dec->Pos))
+   {
+      return false;
+   }
+
+   *Arg = 0;
+   while (ArgBytes > 0)
+   {
+      *Arg = (*Arg << 8) | Dec->Cbor[Dec->Pos++];
+      ArgBytes--;
+   }
+
+   return true;
+
+} /* End CborGetArg() */
+
+
+/******************************************************************************
+** Function: CborParseItem
+**
+*/
+static void CborParseItem(CborToJson_t *Dec, uint16 Depth)
+{
+
+   char   NumStr[NUM_STR_MAX_LEN];
+   uint8  InitialByte;
+   uint8  MajorType;
+   uint8  AddInfo;
+   uint64 Arg = 0;
+   uint64 ItemCnt;
+   bool   Indefinite;
+   double DblValue;
+   float  FltValue;
+   uint32 FltBits;
+
+   if (Dec->Error || Dec->Pos >= Dec->CborLen || Depth > TOPIC_ENC_MAX_DEPTH)
+   {
+      Dec->Error = true;
+      return;
+   }
+
+   InitialByte = Dec->Cbor[Dec->Pos++];
+   MajorType   = InitialByte >> 5;
+   AddInfo     = InitialByte & 0x1F;
+   Indefinite  = (AddInfo == CBOR_AI_INDEFINITE);
+
+   if (MajorType != CBOR_SIMPLE && !Indefinite && !CborGetArg(Dec, AddInfo, &Arg))
+   {
+      Dec->Error = true;
+      return;
+   }
+
+   switch (MajorType)
+   {
+
+      case CBOR_UINT:
+         snprintf(NumStr, sizeof(NumStr), "%llu", (unsigned long long)Arg);
+         JsonPutStr(Dec, NumStr);
+         break;
+
+      case CBOR_NINT:
+         if (Arg < (uint64)INT64_MAX)
+         {
+            snprintf(NumStr, sizeof(NumStr), "%lld", (long long)(-1 - (int64)Arg));
+         }
+         else
+         {
+            snprintf(NumStr, sizeof(NumStr), "%.17g", -1.0 - (double)Arg);
+         }
+         JsonPutStr(Dec, NumStr);
+         break;
+
+      case CBOR_TSTR:
+         /* Compare with the remaining length so a large Arg can't wrap Pos */
+         if (Indefinite || Arg > (uint64)(Dec->CborLen - Dec->Pos))
+         {
+            Dec->Error = true;
+            break;
+         }
+         JsonPutString(Dec, &Dec->Cbor[Dec->Pos], Arg);
+         Dec->Pos += Arg;
+         break;
+
+      case CBOR_ARRAY:
+      case CBOR_MAP:
+         /* Each item is at least one byte so a count can't exceed the remaining length */
+         if (!Indefinite && Arg > (uint64)(Dec->CborLen - Dec->Pos) / ((MajorType == CBOR_MAP) ? 2 : 1))
+         {
+            Dec->Error = true;
+            break;
+         }
+         JsonPutChar(Dec, (MajorType == CBOR_MAP) ? '{' : '[');
+         for (ItemCnt=0; !Dec->Error; ItemCnt++)
+         {
+            if (Indefinite)
+            {
+               if (Dec->Pos >= Dec->CborLen)
+               {
+                  Dec->Error = true;
+                  break;
+               }
+               if (Dec->Cbor[Dec->Pos] == CBOR_BREAK)
+               {
+                  Dec->Pos++;
+                  break;
+               }
+            }
+            else if (ItemCnt >= Arg)
+            {
+               break;
+            }
+            if (ItemCnt > 0)
+            {
+               JsonPutChar(Dec, ',');
+            }
+            if (MajorType == CBOR_MAP)
+            {
+               /* JSON member names must be strings */
+               if (Dec->Pos >= Dec->CborLen || (Dec->Cbor[Dec->Pos] >> 5) != CBOR_TSTR)
+               {
+                  Dec->Error = true;
+                  break;
+               }
+               CborParseItem(Dec, Depth + 1);
+               JsonPutChar(Dec, ':');
+            }
+            CborParseItem(Dec, Depth + 1);
+         }
+         JsonPutChar(Dec, (MajorType == CBOR_MAP) ? '}' : ']');
+         break;
+
+      case CBOR_TAG:
+         /* JSON has no tags so only the tagged data item is converted */
+         if (Indefinite)
+         {
+            Dec->Error = true;
+            break;
+         }
+         CborParseItem(Dec, Depth + 1);
+         break;
+
+      case CBOR_SIMPLE:
+         if (InitialByte == CBOR_FALSE)
+         {
+            JsonPutStr(Dec, "false");
+         }
+         else if (InitialByte == CBOR_TRUE)
+         {
+            JsonPutStr(Dec, "true");
+         }
+         else if (InitialByte == CBOR_NULL || InitialByte == CBOR_UNDEFINED)
+         {
+            JsonPutStr(Dec, "null");
+         }
+         else if (AddInfo >= CBOR_AI_2BYTE && AddInfo <= CBOR_AI_8BYTE && CborGetArg(Dec, AddInfo, &Arg))
+         {
+            if (AddInfo == CBOR_AI_2BYTE)
+            {
+               DblValue = HalfToDouble((uint16)Arg);
+            }
+            else if (AddInfo == CBOR_AI_4BYTE)
+            {
+               FltBits = (uint32)Arg;
+               memcpy(&FltValue, &FltBits, sizeof(FltValue));
+               DblValue = FltValue;
+            }
+            else
+            {
+               memcpy(&DblValue, &Arg, sizeof(DblValue));
+            }
+            if (isfinite(DblValue))
+            {
+               snprintf(NumStr, sizeof(NumStr), "%.17g", DblValue);
+               JsonPutStr(Dec, NumStr);
+            }
+            else
+            {
+               /* JSON can't represent infinity or NaN */
+               JsonPutStr(Dec, "null");
+            }
+         }
+         else
+         {
+            Dec->Error = true;
+         }
+         break;
+
+      default:
+         /* Byte strings can't be represented in JSON */
+         Dec->Error = true;
+         break;
+
+   } /* End major type switch */
+
+} /* End CborParseItem() */
+
+
+/******************************************************************************
+** Function: HalfToDouble
+**
+*/
+static double HalfToDouble(uint16 Half)
+{
+
+   int    Exp  = (Half >> 10) & 0x1F;
+   int    Mant = Half & 0x3FF;
+   double Value;
+
+   if (Exp == 0)
+   {
+      Value = (double)Mant / (double)(1 << 24);
+   }
+   else if (Exp != 31)
+   {
+      /* Value = (Mant + 1024) * 2^(Exp - 25) */
+      Value = (Exp >= 25) ? (double)((Mant + 1024) << (Exp - 25)) :
+                            (double)(Mant + 1024) / (double)(1 << (25 - Exp));
+   }
+   else
+   {
+      Value = (Mant == 0) ? INFINITY : NAN;
+   }
+
+   return (Half & 0x8000) ? -Value : Value;
+
+} /* End HalfToDouble() */
+
+
+/******************************************************************************
+** Function: JsonPutChar
+**
+*/
+static void JsonPutChar(CborToJson_t *Dec, char Char)
+{
+
+   if (Dec->Len < Dec->BufSize)
+   {
+      Dec->Buf[Dec->Len++] = Char;
+   }
+   else
+   {
+      Dec->Error = true;
+   }
+
+} /* End JsonPutChar() */
+
+
+/******************************************************************************
+** Function: JsonPutStr
+**
+*/
+static void JsonPutStr(CborToJson_t *Dec, const char *Str)
+{
+
+   while (*Str != '\0')
+   {
+      JsonPutChar(Dec, *Str++);
+   }
+
+} /* End JsonPutStr() */
+
+
+/******************************************************************************
+** Function: JsonPutString
+**
+** Write a quoted JSON string escaping characters as required by RFC 8259.
+*/
+static void JsonPutString(CborToJson_t *Dec, const uint8 *Str, size_t StrLen)
+{
+
+   char EscStr[8];
+
+   JsonPutChar(Dec, '"');
+
+   for (size_t i=0; i < StrLen; i++)
+   {
+      if (Str[i] == '"' || Str[i] == '\\')
+      {
+         JsonPutChar(Dec, '\\');
+         JsonPutChar(Dec, (char)Str[i]);
+      }
+      else if (Str[i] < 0x20)
+      {
+         snprintf(EscStr, sizeof(EscStr), "\\u%04x", Str[i]);
+         JsonPutStr(Dec, EscStr);
+      }
+      else
+      {
+         JsonPutChar(Dec, (char)Str[i]);
+      }
+   }
+
+   JsonPutChar(Dec, '"');
+
+} /* End JsonPutString() */
@@ -0,0 +1,123 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Encode topic messages using a topic's network encoding
+**
+** Notes:
+**   1. Topic plugins always produce and consume JSON text. A topic's
+**      encoding attribute defines how the message is carried on the
+**      network:
+**        JSON         - JSON text exactly as produced by the topic plugin
+**        COMPACT_JSON - JSON text with whitespace outside strings removed
+**        CBOR         - RFC 8949 Concise Binary Object Representation
+**   2. The protocol apps' SB-to-JSON messages are encoded by the topic
+**      plugin CfeToJson hook which calls TOPIC_ENC_CompactJson() for
+**      COMPACT_JSON topics. See topic_hook.h. Compact JSON is still JSON so
+**      received messages don't need to be decoded. JMSG_LIB's CfeToJson
+**      interface can only return JSON text so CBOR can't be assigned to a
+**      topic until JMSG_LIB provides an interface for binary messages.
+**      TOPIC_ENC_EncodeMsg() and TOPIC_ENC_DecodeMsg() are only used by the
+**      loopback test.
+**   3. JSON objects and arrays are encoded as CBOR indefinite length maps
+**      and arrays so a JSON message can be encoded in a single pass. JSON
+**      numbers without a fraction or exponent are encoded as CBOR integers
+**      and all other numbers are encoded as double precision floats.
+**   4. These functions don't use any global data so they can be called
+**      from any task.
+**
+*/
+
+#ifndef _topic_enc_
+#define _topic_enc_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define TOPIC_ENC_MAX_DEPTH  16   /* Maximum nesting of JSON objects and arrays */
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TOPIC_ENC_CborToJson
+**
+** Convert a CBOR data item to compact null terminated JSON text. Returns the
+** JSON text length or 0 if the CBOR can't be represented as JSON or the
+** buffer is too small.
+**
+*/
+size_t TOPIC_ENC_CborToJson(const uint8 *Cbor, size_t CborLen, char *JsonBuf, size_t JsonBufSize);
+
+
+/******************************************************************************
+** Function: TOPIC_ENC_CompactJson
+**
+** Remove whitespace outside of strings from JSON text. Returns the compact
+** JSON length or 0 if the buffer is too small. The result is null terminated.
+**
+*/
+size_t TOPIC_ENC_CompactJson(const char *Json, size_t JsonLen, char *JsonBuf, size_t JsonBufSize);
+
+
+/******************************************************************************
+** Function: TOPIC_ENC_DecodeMsg
+**
+** Decode a received topic message into JSON text.
+**
+** Notes:
+**   1. JSON encoded messages are not copied and *JsonMsg is set to Msg.
+**   2. Returns the JSON text length or 0 if the message can't be decoded.
+**
+*/
+size_t TOPIC_ENC_DecodeMsg(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const uint8 *Msg, size_t MsgLen,
+                           char *JsonBuf, size_t JsonBufSize, const char **JsonMsg);
+
+
+/******************************************************************************
+** Function: TOPIC_ENC_EncodeMsg
+**
+** Encode a topic plugin's JSON message using the topic's encoding.
+**
+** Notes:
+**   1. JSON encoded messages are not copied and *EncodedMsg is set to Json.
+**   2. Returns the encoded message length or 0 if the message can't be
+**      encoded.
+**
+*/
+size_t TOPIC_ENC_EncodeMsg(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const char *Json, size_t JsonLen,
+                           uint8 *Buf, size_t BufSize, const uint8 **EncodedMsg);
+
+
+/******************************************************************************
+** Function: TOPIC_ENC_JsonToCbor
+**
+** Convert JSON text to a CBOR data item. Returns the CBOR length or 0 if the
+** JSON is invalid or the buffer is too small.
+**
+*/
+size_t TOPIC_ENC_JsonToCbor(const char *Json, size_t JsonLen, uint8 *CborBuf, size_t CborBufSize);
+
+
+#endif /* _topic_enc_ */
@@ -0,0 +1,537 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the SB-to-JSON topic forwarding policy
+**
+** Notes:
+**   None
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "topic_fwd.h"
+#include "topic_hook.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define USEC_PER_SEC  1000000
+
+#define FNV_OFFSET_BASIS  2166136261u
+#define FNV_PRIME         16777619u
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void   ApplyConfig(TOPIC_FWD_Topic_t *Topic);
+static uint32 HashPayload(const CFE_MSG_Message_t *MsgPtr);
+static void   PublishConfig(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+static void   SubtractStats(TOPIC_FWD_Stats_t *Result, const TOPIC_FWD_Stats_t *Stats, const TOPIC_FWD_Stats_t *Base);
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static TOPIC_FWD_Class_t *TopicFwd;
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_Constructor
+**
+*/
+void TOPIC_FWD_Constructor(TOPIC_FWD_Class_t *TopicFwdPtr, const INITBL_Class_t *IniTbl)
+{
+
+   TopicFwd = TopicFwdPtr;
+
+   memset((void*)TopicFwd, 0, sizeof(TOPIC_FWD_Class_t));
+
+   CFE_MSG_Init(CFE_MSG_PTR(TopicFwd->TopicStatsTlm.TelemetryHeader),
+                CFE_SB_ValueToMsgId(INITBL_GetIntConfig(IniTbl, CFG_JMSG_APP_TOPIC_STATS_TLM_TOPICID)),
+                sizeof(JMSG_APP_TopicStatsTlm_t));
+
+} /* End TOPIC_FWD_Constructor() */
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_ConfigTopicOnChangeCmd
+**
+*/
+bool TOPIC_FWD_ConfigTopicOnChangeCmd(void *DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const JMSG_APP_ConfigTopicOnChange_CmdPayload_t *ConfigTopicOnChange = CMDMGR_PAYLOAD_PTR(MsgPtr, JMSG_APP_ConfigTopicOnChange_t);
+   bool RetStatus = false;
+   bool FwdOnChange;
+
+   if (ConfigTopicOnChange->FwdOnChange == APP_C_FW_BooleanUint8_TRUE || ConfigTopicOnChange->FwdOnChange == APP_C_FW_BooleanUint8_FALSE)
+   {
+      FwdOnChange = (ConfigTopicOnChange->FwdOnChange == APP_C_FW_BooleanUint8_TRUE);
+      if (TOPIC_PART_Contains(ConfigTopicOnChange->Id) &&
+          TOPIC_ATTR_TBL_SetOnChange(ConfigTopicOnChange->Id, FwdOnChange, ConfigTopicOnChange->KeepAlive))
+      {
+         PublishConfig(ConfigTopicOnChange->Id);
+         RetStatus = true;
+         CFE_EVS_SendEvent(TOPIC_FWD_CONFIG_ON_CHANGE_EID, CFE_EVS_EventType_INFORMATION,
+                           "Topic %d forward on change %s with a %d second keep-alive",
+                           ConfigTopicOnChange->Id, FwdOnChange ? "enabled" : "disabled",
+                           ConfigTopicOnChange->KeepAlive);
+      }
+      else
+      {
+         EVT_LIM_SendEvent(TOPIC_FWD_CONFIG_ON_CHANGE_EID, ConfigTopicOnChange->Id, CFE_EVS_EventType_ERROR,
+                           "Configure topic on change command rejected, topic plugin ID %d isn't in partition %d..%d",
+                           ConfigTopicOnChange->Id, TOPIC_PART_First(), TOPIC_PART_Last());
+      }
+   }
+   else
+   {
+      EVT_LIM_SendEvent(TOPIC_FWD_CONFIG_ON_CHANGE_EID, ConfigTopicOnChange->Id, CFE_EVS_EventType_ERROR,
+                        "Configure topic %d on change command rejected, invalid boolean value %d",
+                        ConfigTopicOnChange->Id, ConfigTopicOnChange->FwdOnChange);
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_FWD_ConfigTopicOnChangeCmd() */
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_ConfigTopicRateCmd
+**
+*/
+bool TOPIC_FWD_ConfigTopicRateCmd(void *DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const JMSG_APP_ConfigTopicRate_CmdPayload_t *ConfigTopicRate = CMDMGR_PAYLOAD_PTR(MsgPtr, JMSG_APP_ConfigTopicRate_t);
+   bool RetStatus = false;
+
+   if (TOPIC_PART_Contains(ConfigTopicRate->Id) &&
+       TOPIC_ATTR_TBL_SetRate(ConfigTopicRate->Id, ConfigTopicRate->Decimation, ConfigTopicRate->MaxRate))
+   {
+      PublishConfig(ConfigTopicRate->Id);
+      RetStatus = true;
+      CFE_EVS_SendEvent(TOPIC_FWD_CONFIG_RATE_EID, CFE_EVS_EventType_INFORMATION,
+                        "Topic %d forwarding set to every %d messages with a %d msg/sec limit",
+                        ConfigTopicRate->Id, ConfigTopicRate->Decimation, ConfigTopicRate->MaxRate);
+   }
+   else
+   {
+      EVT_LIM_SendEvent(TOPIC_FWD_CONFIG_RATE_EID, ConfigTopicRate->Id, CFE_EVS_EventType_ERROR,
+                        "Configure topic rate command rejected, topic plugin ID %d isn't in partition %d..%d",
+                        ConfigTopicRate->Id, TOPIC_PART_First(), TOPIC_PART_Last());
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_FWD_ConfigTopicRateCmd() */
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_ForwardSbMsg
+**
+*/
+bool TOPIC_FWD_ForwardSbMsg(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   bool   Forward = true;
+   uint32 PayloadHash = 0;
+   int64  ElapsedUsec;
+   OS_time_t CurrentTime;
+   TOPIC_FWD_Topic_t *Topic;
+   const TOPIC_FWD_Config_t *Config;
+
+   if (TOPIC_PART_Contains(TopicPlugin))
+   {
+
+      Topic = &TopicFwd->Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+      ApplyConfig(Topic);
+      Config = &Topic->AppliedConfig;
+
+      SEQLOCK_WriteBegin(&Topic->StatsSeq);
+      SEQLOCK_IncCnt(&Topic->Stats.SbMsgCnt);
+
+      if (Config->Decimation > 1)
+      {
+         if (Topic->DecimationCnt > 0)
+         {
+            Forward = false;
+            SEQLOCK_IncCnt(&Topic->Stats.DecimatedCnt);
+         }
+         if (++Topic->DecimationCnt >= Config->Decimation)
+         {
+            Topic->DecimationCnt = 0;
+         }
+      }
+
+      if (Forward && (Config->FwdOnChange || Config->MaxRate > 0))
+      {
+         
+         OS_GetLocalTime(&CurrentTime);
+         ElapsedUsec = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(CurrentTime, Topic->LastFwdTime));
+         
+         if (Config->FwdOnChange)
+         {
+            PayloadHash = HashPayload(MsgPtr);
+            if (Topic->PayloadHashValid && (PayloadHash == Topic->PayloadHash) &&
+                (Config->KeepAlive == 0 || ElapsedUsec < ((int64)Config->KeepAlive * USEC_PER_SEC)))
+            {
+               Forward = false;
+               SEQLOCK_IncCnt(&Topic->Stats.UnchangedCnt);
+            }
+         }
+         
+         if (Forward && Config->MaxRate > 0)
+         {
+            if (Topic->Stats.FwdCnt > 0 && ElapsedUsec < (USEC_PER_SEC / Config->MaxRate))
+            {
+               Forward = false;
+               SEQLOCK_IncCnt(&Topic->Stats.RateLimitedCnt);
+            }
+         }
+         
+         /* A changed message that is rate limited is still a change when it's next received */
+         if (Forward)
+         {
+            Topic->LastFwdTime      = CurrentTime;
+            Topic->PayloadHash      = PayloadHash;
+            Topic->PayloadHashValid = (Config->FwdOnChange != 0);
+         }
+         
+      } /* End if time-based policy */
+
+      if (Forward)
+      {
+         SEQLOCK_IncCnt(&Topic->Stats.FwdCnt);
+      }
+      SEQLOCK_WriteEnd(&Topic->StatsSeq);
+
+   } /* End if valid topic */
+
+   return Forward;
+
+} /* End TOPIC_FWD_ForwardSbMsg() */
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_GetEncoding
+**
+*/
+JMSG_APP_TopicEncoding_Enum_t TOPIC_FWD_GetEncoding(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   JMSG_APP_TopicEncoding_Enum_t Encoding = TOPIC_ATTR_TBL_DEF_ENCODING;
+
+   if (TOPIC_PART_Contains(TopicPlugin))
+   {
+      Encoding = (JMSG_APP_TopicEncoding_Enum_t)TopicFwd->Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN].AppliedConfig.Encoding;
+   }
+
+   return Encoding;
+
+} /* End TOPIC_FWD_GetEncoding() */
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_GetTopicStats
+**
+*/
+bool TOPIC_FWD_GetTopicStats(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, TOPIC_FWD_Stats_t *Stats)
+{
+
+   const TOPIC_FWD_Topic_t *Topic;
+   TOPIC_FWD_Stats_t Snapshot;
+   bool RetStatus = false;
+
+   if (TOPIC_PART_Contains(TopicPlugin))
+   {
+      Topic = &TopicFwd->Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+      if (SEQLOCK_ReadSnapshot(&Topic->StatsSeq, &Topic->Stats, &Snapshot, sizeof(TOPIC_FWD_Stats_t), SEQLOCK_READ_DELAY_LIM))
+      {
+         SubtractStats(Stats, &Snapshot, &Topic->ResetStats);
+         RetStatus = true;
+      }
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_FWD_GetTopicStats() */
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_LoadAttrTblCmd
+**
+*/
+bool TOPIC_FWD_LoadAttrTblCmd(APP_C_FW_TblLoadOptions_Enum_t LoadType, const char *Filename)
+{
+
+   bool RetStatus = TOPIC_ATTR_TBL_LoadCmd(LoadType, Filename);
+
+   if (RetStatus)
+   {
+      for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); i <= TOPIC_PART_Last(); i++)
+      {
+         PublishConfig(i);
+      }
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_FWD_LoadAttrTblCmd() */
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_ResetStatus
+**
+** Notes:
+**   1. The counters are owned by the protocol apps so a snapshot is saved
+**      as the baseline rather than clearing them. A topic's baseline isn't
+**      changed if a consistent snapshot can't be read.
+**
+*/
+void TOPIC_FWD_ResetStatus(void)
+{
+
+   TOPIC_FWD_Topic_t *Topic;
+   TOPIC_FWD_Stats_t Snapshot;
+
+   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); i <= TOPIC_PART_Last(); i++)
+   {
+      Topic = &TopicFwd->Topic[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+      if (SEQLOCK_ReadSnapshot(&Topic->StatsSeq, &Topic->Stats, &Snapshot, sizeof(TOPIC_FWD_Stats_t), SEQLOCK_READ_DELAY_LIM))
+      {
+         Topic->ResetStats = Snapshot;
+      }
+   }
+
+} /* End TOPIC_FWD_ResetStatus() */
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_RestoreStats
+**
+** Notes:
+**   1. The reset baseline is set to the current counts minus the saved
+**      counts so the protocol apps remain the only writers. The saved
+**      counts aren't restored if a consistent snapshot can't be read.
+**
+*/
+void TOPIC_FWD_RestoreStats(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const TOPIC_FWD_Stats_t *Stats)
+{
+
+   TOPIC_FWD_Topic_t *Topic;
+   TOPIC_FWD_Stats_t Snapshot;
+
+   if (TOPIC_PART_Contains(TopicPlugin))
+   {
+      Topic = &TopicFwd->Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+      if (SEQLOCK_ReadSnapshot(&Topic->StatsSeq, &Topic->Stats, &Snapshot, sizeof(TOPIC_FWD_Stats_t), SEQLOCK_READ_DELAY_LIM))
+      {
+         SubtractStats(&Topic->ResetStats, &Snapshot, Stats);
+      }
+   }
+
+} /* End TOPIC_FWD_RestoreStats() */
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_SendTopicStatsTlmCmd
+**
+*/
+bool TOPIC_FWD_SendTopicStatsTlmCmd(void *DataObjPtr, const CFE_MSG_Message_t *MsgPtr)
+{
+
+   const JMSG_APP_SendTopicStatsTlm_CmdPayload_t *SendTopicStats = CMDMGR_PAYLOAD_PTR(MsgPtr, JMSG_APP_SendTopicStatsTlm_t);
+   JMSG_APP_TopicStatsTlm_Payload_t *Payload = &TopicFwd->TopicStatsTlm.Payload;
+   const TOPIC_ATTR_TBL_Topic_t *TopicAttr   = TOPIC_ATTR_TBL_GetTopic(SendTopicStats->Id);
+   TOPIC_FWD_Stats_t Stats;
+   bool RetStatus = false;
+
+   if (TopicAttr == NULL || !TOPIC_PART_Contains(SendTopicStats->Id))
+   {
+      EVT_LIM_SendEvent(TOPIC_FWD_SEND_STATS_TLM_EID, SendTopicStats->Id, CFE_EVS_EventType_ERROR,
+                        "Send topic statistics telemetry rejected, topic plugin ID %d isn't in partition %d..%d",
+                        SendTopicStats->Id, TOPIC_PART_First(), TOPIC_PART_Last());
+   }
+   else if (TOPIC_FWD_GetTopicStats(SendTopicStats->Id, &Stats))
+   {
+
+      Payload->Id             = SendTopicStats->Id;
+      Payload->Decimation     = TopicAttr->Decimation;
+      Payload->MaxRate        = TopicAttr->MaxRate;
+      Payload->FwdOnChange    = TopicAttr->FwdOnChange ? APP_C_FW_BooleanUint8_TRUE : APP_C_FW_BooleanUint8_FALSE;
+      Payload->KeepAlive      = TopicAttr->KeepAlive;
+      Payload->Encoding       = TopicAttr->Encoding;
+      Payload->Hooked         = TOPIC_HOOK_Hooked(SendTopicStats->Id) ? APP_C_FW_BooleanUint8_TRUE : APP_C_FW_BooleanUint8_FALSE;
+      Payload->ConvRejected   = TOPIC_HOOK_ConvRejected(SendTopicStats->Id) ? APP_C_FW_BooleanUint8_TRUE : APP_C_FW_BooleanUint8_FALSE;
+      Payload->SbMsgCnt       = Stats.SbMsgCnt;
+      Payload->FwdCnt         = Stats.FwdCnt;
+      Payload->DecimatedCnt   = Stats.DecimatedCnt;
+      Payload->RateLimitedCnt = Stats.RateLimitedCnt;
+      Payload->UnchangedCnt   = Stats.UnchangedCnt;
+
+      CFE_SB_TimeStampMsg(CFE_MSG_PTR(TopicFwd->TopicStatsTlm.TelemetryHeader));
+      CFE_SB_TransmitMsg(CFE_MSG_PTR(TopicFwd->TopicStatsTlm.TelemetryHeader), true);
+      RetStatus = true;
+   }
+   else
+   {
+      EVT_LIM_SendEvent(TOPIC_FWD_SEND_STATS_TLM_EID, SendTopicStats->Id, CFE_EVS_EventType_ERROR,
+                        "Send topic statistics telemetry failed, topic %d statistics are being updated by its protocol app",
+                        SendTopicStats->Id);
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_FWD_SendTopicStatsTlmCmd() */
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_SetEncoding
+**
+*/
+bool TOPIC_FWD_SetEncoding(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, JMSG_APP_TopicEncoding_Enum_t Encoding)
+{
+
+   bool RetStatus = false;
+
+   if (TOPIC_PART_Contains(TopicPlugin) && TOPIC_ATTR_TBL_SetEncoding(TopicPlugin, Encoding))
+   {
+      PublishConfig(TopicPlugin);
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_FWD_SetEncoding() */
+
+
+/******************************************************************************
+** Function: ApplyConfig
+**
+** Called by the owning protocol app to apply the forwarding configuration
+** last published by JMSG_APP.
+**
+** Notes:
+**   1. The seqlock read never blocks. If JMSG_APP is publishing a new
+**      configuration the previously applied configuration is used.
+**   2. The decimation count and payload hash are reset by the protocol app
+**      because it is their only writer.
+**
+*/
+static void ApplyConfig(TOPIC_FWD_Topic_t *Topic)
+{
+
+   TOPIC_FWD_Config_t Config;
+
+   if (SEQLOCK_ReadSnapshot(&Topic->ConfigSeq, &Topic->Config, &Config, sizeof(TOPIC_FWD_Config_t), 0) &&
+       Config.Gen != Topic->AppliedConfig.Gen)
+   {
+      Topic->AppliedConfig    = Config;
+      Topic->DecimationCnt    = 0;
+      Topic->PayloadHashValid = false;
+   }
+
+} /* End ApplyConfig() */
+
+
+/******************************************************************************
+** Function: HashPayload
+**
+** Compute a 32-bit FNV-1a hash of a message's payload.
+**
+** Notes:
+**   1. The message header is excluded because it contains a time stamp and
+**      sequence counter that change for every message.
+**
+*/
+static uint32 HashPayload(const CFE_MSG_Message_t *MsgPtr)
+{
+
+   uint32 Hash = FNV_OFFSET_BASIS;
+   CFE_MSG_Size_t MsgSize = 0;
+   CFE_MSG_Type_t MsgType = CFE_MSG_Type_Invalid;
+   size_t HdrSize;
+   const uint8 *MsgByte = (const uint8 *)MsgPtr;
+
+   CFE_MSG_GetSize(MsgPtr, &MsgSize);
+   CFE_MSG_GetType(MsgPtr, &MsgType);
+
+   HdrSize = (MsgType == CFE_MSG_Type_Tlm) ? sizeof(CFE_MSG_TelemetryHeader_t) : sizeof(CFE_MSG_CommandHeader_t);
+
+   for (size_t i=HdrSize; i < MsgSize; i++)
+   {
+      Hash ^= MsgByte[i];
+      Hash *= FNV_PRIME;
+   }
+
+   return Hash;
+
+} /* End HashPayload() */
+
+
+/******************************************************************************
+** Function: PublishConfig
+**
+** Publish a topic's forwarding attributes to its protocol app.
+**
+*/
+static void PublishConfig(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   TOPIC_FWD_Topic_t *Topic = &TopicFwd->Topic[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+   const TOPIC_ATTR_TBL_Topic_t *TopicAttr = TOPIC_ATTR_TBL_GetTopic(TopicPlugin);
+
+   SEQLOCK_WriteBegin(&Topic->ConfigSeq);
+   SEQLOCK_Store(&Topic->Config.Gen,         Topic->Config.Gen + 1);
+   SEQLOCK_Store(&Topic->Config.Decimation,  TopicAttr->Decimation);
+   SEQLOCK_Store(&Topic->Config.MaxRate,     TopicAttr->MaxRate);
+   SEQLOCK_Store(&Topic->Config.FwdOnChange, TopicAttr->FwdOnChange);
+   SEQLOCK_Store(&Topic->Config.KeepAlive,   TopicAttr->KeepAlive);
+   SEQLOCK_Store(&Topic->Config.Encoding,    TopicAttr->Encoding);
+   SEQLOCK_WriteEnd(&Topic->ConfigSeq);
+
+} /* End PublishConfig() */
+
+
+/******************************************************************************
+** Function: SubtractStats
+**
+** Result = Stats - Base. Result may be the same object as Stats or Base.
+**
+*/
+static void SubtractStats(TOPIC_FWD_Stats_t *Result, const TOPIC_FWD_Stats_t *Stats, const TOPIC_FWD_Stats_t *Base)
+{
+
+   TOPIC_FWD_Stats_t Diff;
+
+   Diff.SbMsgCnt       = Stats->SbMsgCnt       - Base->SbMsgCnt;
+   Diff.FwdCnt         = Stats->FwdCnt         - Base->FwdCnt;
+   Diff.DecimatedCnt   = Stats->DecimatedCnt   - Base->DecimatedCnt;
+   Diff.RateLimitedCnt = Stats->RateLimitedCnt - Base->RateLimitedCnt;
+   Diff.UnchangedCnt   = Stats->UnchangedCnt   - Base->UnchangedCnt;
+
+   *Result = Diff;
+
+} /* End SubtractStats() */
@@ -0,0 +1,294 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Decide whether SB messages are forwarded as JSON messages
+**
+** Notes:
+**   1. TOPIC_FWD_ForwardSbMsg() is called by the topic plugin CfeToJson
+**      hook before a SB message is converted to JSON. See topic_hook.h.
+**      Messages that are not forwarded are not converted or sent.
+**   2. The forwarding policy for each topic is defined in the topic
+**      attribute table. Decimation, rate limit, forward on change and
+**      keep-alive only take effect for topic plugins that are hooked.
+**      TopicStatsTlm reports whether a topic plugin is hooked.
+**   3. TOPIC_FWD_ForwardSbMsg() is called from JMSG protocol app tasks and
+**      each topic is owned by one protocol app. The owning protocol app's
+**      task is the only writer of a topic's statistics and forwarding
+**      state. JMSG_APP reads the statistics using SEQLOCK_ReadSnapshot()
+**      and resets them by saving a baseline snapshot so the message path
+**      never waits on JMSG_APP.
+**   4. JMSG_APP is the only writer of the topic attribute table. When a
+**      topic's forwarding attributes or encoding change JMSG_APP publishes
+**      a copy with a new generation number through a seqlock. The protocol
+**      app reads the copy without blocking and resets its decimation count
+**      and payload hash when the generation changes. If the copy is being
+**      written the previous configuration is used for that message.
+**
+*/
+
+#ifndef _topic_fwd_
+#define _topic_fwd_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "topic_attr_tbl.h"
+#include "topic_part.h"
+#include "seqlock.h"
+#include "evt_lim.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define TOPIC_FWD_CONFIG_RATE_EID      (TOPIC_FWD_BASE_EID + 0)
+#define TOPIC_FWD_SEND_STATS_TLM_EID   (TOPIC_FWD_BASE_EID + 1)
+#define TOPIC_FWD_CONFIG_ON_CHANGE_EID (TOPIC_FWD_BASE_EID + 2)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Forwarding statistics for one topic
+**
+** Only contains uint32 counters so it can be read with SEQLOCK_ReadSnapshot()
+*/
+
+typedef struct
+{
+
+   uint32  SbMsgCnt;
+   uint32  FwdCnt;
+   uint32  DecimatedCnt;
+   uint32  RateLimitedCnt;
+   uint32  UnchangedCnt;
+
+} TOPIC_FWD_Stats_t;
+
+
+/******************************************************************************
+** Forwarding configuration for one topic
+**
+** Only contains uint32 words so it can be read with SEQLOCK_ReadSnapshot()
+*/
+
+typedef struct
+{
+
+   uint32  Gen;          /* Incremented each time JMSG_APP publishes the configuration */
+   uint32  Decimation;
+   uint32  MaxRate;
+   uint32  FwdOnChange;
+   uint32  KeepAlive;
+   uint32  Encoding;
+
+} TOPIC_FWD_Config_t;
+
+
+/******************************************************************************
+** Forwarding state and statistics for one topic
+*/
+
+typedef struct
+{
+
+   uint32              ConfigSeq;
+   TOPIC_FWD_Config_t  Config;         /* Written by JMSG_APP */
+
+   TOPIC_FWD_Config_t  AppliedConfig;  /* Owning protocol app's copy */
+   uint16     DecimationCnt;
+   OS_time_t  LastFwdTime;
+   bool       PayloadHashValid;
+   uint32     PayloadHash;
+
+   uint32             StatsSeq;
+   TOPIC_FWD_Stats_t  Stats;       /* Written by the owning protocol app */
+   TOPIC_FWD_Stats_t  ResetStats;  /* Snapshot saved by the last reset   */
+
+} TOPIC_FWD_Topic_t;
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   /*
+   ** Telemetry Packets
+   */
+
+   JMSG_APP_TopicStatsTlm_t  TopicStatsTlm;
+
+   /*
+   ** Class State Data
+   */
+
+   TOPIC_FWD_Topic_t  Topic[JMSG_APP_TOPIC_PLUGIN_CNT];
+
+} TOPIC_FWD_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_Constructor
+**
+*/
+void TOPIC_FWD_Constructor(TOPIC_FWD_Class_t *TopicFwdPtr, const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_ConfigTopicOnChangeCmd
+**
+** Configure whether a topic only forwards SB messages when their payload
+** changes and the keep-alive period for unchanged payloads
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. DataObjPtr is not used
+**
+*/
+bool TOPIC_FWD_ConfigTopicOnChangeCmd(void *DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_ConfigTopicRateCmd
+**
+** Set a topic's decimation factor and maximum forwarding rate
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. DataObjPtr is not used
+**
+*/
+bool TOPIC_FWD_ConfigTopicRateCmd(void *DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_ForwardSbMsg
+**
+** Return true if a topic's SB message should be converted to JSON and sent.
+**
+** Notes:
+**   1. Policies are applied in the order decimation, forward on change and
+**      rate limit so a dropped message doesn't consume the topic's rate
+**      allocation.
+**   2. Forward on change compares a hash of the SB message payload with the
+**      hash of the last forwarded payload. An unchanged payload is forwarded
+**      when the keep-alive period has expired. A keep-alive of 0 disables
+**      the keep-alive.
+**   3. Invalid topic plugin IDs are always forwarded so JMSG_LIB's behavior
+**      is unchanged for topics JMSG_APP doesn't know about.
+**
+*/
+bool TOPIC_FWD_ForwardSbMsg(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_GetEncoding
+**
+** Return the encoding a protocol app applies to a topic's JSON messages.
+**
+** Notes:
+**   1. Only called by the topic's CfeToJson hook after
+**      TOPIC_FWD_ForwardSbMsg() so it returns the configuration applied by
+**      the owning protocol app's task.
+**
+*/
+JMSG_APP_TopicEncoding_Enum_t TOPIC_FWD_GetEncoding(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_GetTopicStats
+**
+** Return a topic's forwarding statistics since the last reset. Returns false
+** if the topic plugin isn't in this instance's partition or a consistent
+** snapshot couldn't be read because the owning protocol app was preempted
+** while updating them.
+**
+*/
+bool TOPIC_FWD_GetTopicStats(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, TOPIC_FWD_Stats_t *Stats);
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_LoadAttrTblCmd
+**
+** Load the topic attribute table and publish the partition's forwarding
+** configurations.
+**
+** Notes:
+**  1. Function signature must match TBLMGR_LoadTblFuncPtr_t.
+**  2. Must be registered after TOPIC_FWD_Constructor() is called.
+**
+*/
+bool TOPIC_FWD_LoadAttrTblCmd(APP_C_FW_TblLoadOptions_Enum_t LoadType, const char *Filename);
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_ResetStatus
+**
+*/
+void TOPIC_FWD_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_RestoreStats
+**
+** Restore a topic's statistics saved before a restart. Messages counted
+** since the topic's counters were created are added to the saved counts.
+**
+*/
+void TOPIC_FWD_RestoreStats(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const TOPIC_FWD_Stats_t *Stats);
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_SendTopicStatsTlmCmd
+**
+** Send a topic's forwarding statistics telemetry packet
+**
+** Notes:
+**   1. Signature must match CMDMGR_CmdFuncPtr_t
+**   2. DataObjPtr is not used
+**
+*/
+bool TOPIC_FWD_SendTopicStatsTlmCmd(void *DataObjPtr, const CFE_MSG_Message_t *MsgPtr);
+
+
+/******************************************************************************
+** Function: TOPIC_FWD_SetEncoding
+**
+** Set a topic's encoding in the topic attribute table and publish it to the
+** topic's protocol app. Returns false if the topic plugin isn't in this
+** instance's partition or the encoding is invalid.
+**
+*/
+bool TOPIC_FWD_SetEncoding(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, JMSG_APP_TopicEncoding_Enum_t Encoding);
+
+
+#endif /* _topic_fwd_ */
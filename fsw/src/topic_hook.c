@@ -0,0 +1,444 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the topic plugin SB-to-JSON hook
+**
+** Notes:
+**   1. The hook functions run in the JMSG protocol app tasks. The saved
+**      CfeToJson functions and converters are written before the hook is
+**      registered and are never cleared so a protocol app never calls a
+**      NULL function.
+**   2. JMSG_LIB's topic table is written by the USR_TPLUG owner's task
+**      without synchronization. The only topic table field the hook reads
+**      is a topic's message ID and it is read atomically. Forwarding
+**      attributes and statistics are shared through TOPIC_FWD's seqlocks.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "topic_hook.h"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static bool CfeToJson(const char **JsonMsgPayload, const CFE_MSG_Message_t *CfeMsg);
+static bool ClaimTopicPlugin(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+static void CompactPayload(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const char **JsonMsgPayload);
+static bool ConvertPayload(const TOPIC_CONV_Conv_t *Conv, const char **JsonMsgPayload, const CFE_MSG_Message_t *CfeMsg);
+static bool FindTopicPlugin(CFE_SB_MsgId_t MsgId, JMSG_PLATFORM_TopicPlugin_Enum_t *TopicPlugin);
+static bool SharesMsgId(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+#ifdef JMSG_APP_TOPIC_CONV
+static const TOPIC_CONV_Conv_t *VerifyConv(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const TOPIC_CONV_Conv_t *Conv,
+                                           JMSG_TOPIC_TBL_CfeToJson_t PluginCfeToJson, const CFE_MSG_Message_t *CfeMsg);
+#endif
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static TOPIC_HOOK_Class_t *TopicHook;
+
+
+/******************************************************************************
+** Function: TOPIC_HOOK_Constructor
+**
+*/
+void TOPIC_HOOK_Constructor(TOPIC_HOOK_Class_t *TopicHookPtr)
+{
+
+   TopicHook = TopicHookPtr;
+
+   memset((void*)TopicHook, 0, sizeof(TOPIC_HOOK_Class_t));
+
+} /* End TOPIC_HOOK_Constructor() */
+
+
+/******************************************************************************
+** Function: TOPIC_HOOK_ConvRejected
+**
+*/
+bool TOPIC_HOOK_ConvRejected(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   bool Rejected = false;
+
+   if (TOPIC_PART_Contains(TopicPlugin))
+   {
+      Rejected = __atomic_load_n(&TopicHook->ConvRejected[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN], __ATOMIC_RELAXED);
+   }
+
+   return Rejected;
+
+} /* End TOPIC_HOOK_ConvRejected() */
+
+
+/******************************************************************************
+** Function: TOPIC_HOOK_Hooked
+**
+*/
+bool TOPIC_HOOK_Hooked(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   const JMSG_TOPIC_TBL_Topic_t *Topic;
+   bool Hooked = false;
+
+   if (TOPIC_PART_Contains(TopicPlugin))
+   {
+      Topic  = JMSG_TOPIC_TBL_GetTopic(TopicPlugin);
+      Hooked = (Topic != NULL && Topic->CfeToJson == CfeToJson &&
+                TopicHook->CfeToJson[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN] != NULL);
+   }
+
+   return Hooked;
+
+} /* End TOPIC_HOOK_Hooked() */
+
+
+/******************************************************************************
+** Function: TOPIC_HOOK_Install
+**
+** Notes:
+**   1. A topic plugin that is already hooked isn't hooked again so this can
+**      be called after the topic plugins are reconstructed.
+**
+*/
+void TOPIC_HOOK_Install(void)
+{
+
+   uint16 SharedMsgIdCnt = 0;
+   uint16 NotOwnCnt = 0;
+   const JMSG_TOPIC_TBL_Topic_t *Topic;
+   JMSG_TOPIC_TBL_CfeToJson_t    PluginCfeToJson;
+   const TOPIC_CONV_Conv_t      *Conv = NULL;
+
+   TopicHook->HookedCnt = 0;
+   TopicHook->ConvCnt   = 0;
+
+   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); i <= TOPIC_PART_Last(); i++)
+   {
+
+      Topic = JMSG_TOPIC_TBL_GetTopic(i);
+      if (Topic == NULL || Topic->CfeToJson == NULL)
+      {
+         continue;
+      }
+
+      if (Topic->CfeToJson != CfeToJson)
+      {
+         if (SharesMsgId(i))
+         {
+            SharedMsgIdCnt++;
+            continue;
+         }
+         PluginCfeToJson = TopicHook->CfeToJson[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+         if ((PluginCfeToJson != NULL && Topic->CfeToJson != PluginCfeToJson) ||
+             (PluginCfeToJson == NULL && !ClaimTopicPlugin(i)))
+         {
+            NotOwnCnt++;
+            continue;
+         }
+#ifdef JMSG_APP_TOPIC_CONV
+         Conv = TOPIC_CONV_GetTopicConv(i);
+#endif
+         __atomic_store_n(&TopicHook->Conv[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN], Conv, __ATOMIC_RELEASE);
+         __atomic_store_n(&TopicHook->CfeToJson[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN], Topic->CfeToJson, __ATOMIC_RELEASE);
+         JMSG_TOPIC_TBL_RegisterPlugin(i, CfeToJson, Topic->JsonToCfe, Topic->PluginTest);
+      }
+      TopicHook->HookedCnt++;
+      if (TopicHook->Conv[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN] != NULL)
+      {
+         TopicHook->ConvCnt++;
+      }
+
+   } /* End topic plugin loop */
+
+   CFE_EVS_SendEvent(TOPIC_HOOK_INSTALL_EID, (SharedMsgIdCnt == 0 && NotOwnCnt == 0) ? CFE_EVS_EventType_INFORMATION : CFE_EVS_EventType_ERROR,
+                     "Forwarding policy applied to %d topic plugins in partition %d..%d, %d with generated converters. Not hooked: %d share a message ID, %d not the topic plugin's own CfeToJson",
+                     TopicHook->HookedCnt, TOPIC_PART_First(), TOPIC_PART_Last(), TopicHook->ConvCnt, SharedMsgIdCnt, NotOwnCnt);
+
+} /* End TOPIC_HOOK_Install() */
+
+
+/******************************************************************************
+** Function: TOPIC_HOOK_Remove
+**
+*/
+void TOPIC_HOOK_Remove(void)
+{
+
+   JMSG_TOPIC_TBL_CfeToJson_t    PluginCfeToJson;
+   const JMSG_TOPIC_TBL_Topic_t *Topic;
+
+   /* The app may exit before it was initialized */
+   if (TopicHook == NULL || TopicHook->HookedCnt == 0)
+   {
+      return;
+   }
+
+   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); i <= TOPIC_PART_Last(); i++)
+   {
+
+      Topic = JMSG_TOPIC_TBL_GetTopic(i);
+      PluginCfeToJson = TopicHook->CfeToJson[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+      if (Topic != NULL && Topic->CfeToJson == CfeToJson && PluginCfeToJson != NULL)
+      {
+         JMSG_TOPIC_TBL_RegisterPlugin(i, PluginCfeToJson, Topic->JsonToCfe, Topic->PluginTest);
+      }
+      if (TopicHook->Claimed[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN])
+      {
+         CFE_ES_DeleteGenCounter(TopicHook->ClaimId[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN]);
+         TopicHook->Claimed[i - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN] = false;
+      }
+
+   }
+
+   TopicHook->HookedCnt = 0;
+
+} /* End TOPIC_HOOK_Remove() */
+
+
+/******************************************************************************
+** Function: CfeToJson
+**
+** Hook registered as each topic plugin's CfeToJson function. Returns false
+** without converting the message if the forwarding policy drops it. The
+** message is converted by the topic's generated converter if it has one
+** and is compacted if the topic uses the COMPACT_JSON encoding.
+**
+*/
+static bool CfeToJson(const char **JsonMsgPayload, const CFE_MSG_Message_t *CfeMsg)
+{
+
+   bool RetStatus = false;
+   CFE_SB_MsgId_t MsgId;
+   JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin;
+   JMSG_TOPIC_TBL_CfeToJson_t PluginCfeToJson;
+   const TOPIC_CONV_Conv_t   *Conv;
+
+   if (CFE_MSG_GetMsgId(CfeMsg, &MsgId) == CFE_SUCCESS && FindTopicPlugin(MsgId, &TopicPlugin))
+   {
+      PluginCfeToJson = __atomic_load_n(&TopicHook->CfeToJson[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN], __ATOMIC_ACQUIRE);
+      Conv = __atomic_load_n(&TopicHook->Conv[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN], __ATOMIC_ACQUIRE);
+      if (PluginCfeToJson != NULL && TOPIC_FWD_ForwardSbMsg(TopicPlugin, CfeMsg))
+      {
+#ifdef JMSG_APP_TOPIC_CONV
+         if (Conv != NULL && !TopicHook->ConvVerified[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN])
+         {
+            Conv = VerifyConv(TopicPlugin, Conv, PluginCfeToJson, CfeMsg);
+         }
+#endif
+         if (Conv != NULL)
+         {
+            RetStatus = ConvertPayload(Conv, JsonMsgPayload, CfeMsg);
+         }
+         else
+         {
+            RetStatus = PluginCfeToJson(JsonMsgPayload, CfeMsg);
+         }
+         if (RetStatus && TOPIC_FWD_GetEncoding(TopicPlugin) == JMSG_APP_TopicEncoding_COMPACT_JSON)
+         {
+            CompactPayload(TopicPlugin, JsonMsgPayload);
+         }
+      }
+   }
+
+   return RetStatus;
+
+} /* End CfeToJson() */
+
+
+/******************************************************************************
+** Function: ClaimTopicPlugin
+**
+** Register the topic plugin's claim counter. Fails if another instance
+** claimed the topic plugin.
+**
+*/
+static bool ClaimTopicPlugin(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   char ClaimName[OS_MAX_API_NAME];
+   uint16 Idx = TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN;
+
+   if (!TopicHook->Claimed[Idx])
+   {
+      snprintf(ClaimName, sizeof(ClaimName), TOPIC_HOOK_CLAIM_NAME_FMT, TopicPlugin);
+      TopicHook->Claimed[Idx] = (CFE_ES_RegisterGenCounter(&TopicHook->ClaimId[Idx], ClaimName) == CFE_SUCCESS);
+   }
+
+   return TopicHook->Claimed[Idx];
+
+} /* End ClaimTopicPlugin() */
+
+
+/******************************************************************************
+** Function: CompactPayload
+**
+** Remove the whitespace outside of strings from a topic's JSON payload. The
+** payload is left unchanged if it doesn't fit in the topic's buffer.
+**
+*/
+static void CompactPayload(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const char **JsonMsgPayload)
+{
+
+   char *CompactJson = TopicHook->CompactJson[TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN];
+
+   if (TOPIC_ENC_CompactJson(*JsonMsgPayload, strlen(*JsonMsgPayload), CompactJson, JMSG_APP_TOPIC_COMPACT_JSON_MAX_LEN) > 0)
+   {
+      *JsonMsgPayload = CompactJson;
+   }
+
+} /* End CompactPayload() */
+
+
+/******************************************************************************
+** Function: ConvertPayload
+**
+** Convert a SB message payload to JSON with a generated converter. Returns
+** false if the message is shorter than the converter's payload or the JSON
+** doesn't fit in the converter's buffer.
+**
+*/
+static bool ConvertPayload(const TOPIC_CONV_Conv_t *Conv, const char **JsonMsgPayload, const CFE_MSG_Message_t *CfeMsg)
+{
+
+   bool RetStatus = false;
+   CFE_MSG_Message_t *Msg = (CFE_MSG_Message_t *)CfeMsg;  /* cFE user data API isn't const */
+
+   if (CFE_SB_GetUserDataLength(Msg) >= Conv->PayloadSize &&
+       Conv->ToJson(CFE_SB_GetUserData(Msg), Conv->JsonBuf, JMSG_APP_TOPIC_CONV_JSON_MAX_LEN) > 0)
+   {
+      *JsonMsgPayload = Conv->JsonBuf;
+      RetStatus = true;
+   }
+
+   return RetStatus;
+
+} /* End ConvertPayload() */
+
+
+/******************************************************************************
+** Function: FindTopicPlugin
+**
+** Find the partition topic plugin that owns a message ID.
+**
+** Notes:
+**   1. The topic plugin table is searched if the message ID isn't indexed
+**      because a topic plugin can receive messages after it is enabled and
+**      before the index is updated.
+**
+*/
+static bool FindTopicPlugin(CFE_SB_MsgId_t MsgId, JMSG_PLATFORM_TopicPlugin_Enum_t *TopicPlugin)
+{
+
+   bool Found = TOPIC_IDX_GetTopicPlugin(MsgId, TopicPlugin);
+   const JMSG_TOPIC_TBL_Topic_t *Topic;
+
+   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); !Found && i <= TOPIC_PART_Last(); i++)
+   {
+      Topic = JMSG_TOPIC_TBL_GetTopic(i);
+      if (Topic != NULL && CFE_SB_MsgId_Equal(CFE_SB_ValueToMsgId(__atomic_load_n(&Topic->Cfe, __ATOMIC_RELAXED)), MsgId))
+      {
+         *TopicPlugin = i;
+         Found = true;
+      }
+   }
+
+   return Found;
+
+} /* End FindTopicPlugin() */
+
+
+/******************************************************************************
+** Function: SharesMsgId
+**
+** Return true if another topic plugin in the partition uses the same SB
+** message ID.
+**
+*/
+static bool SharesMsgId(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   bool Shared = false;
+   const JMSG_TOPIC_TBL_Topic_t *Topic = JMSG_TOPIC_TBL_GetTopic(TopicPlugin);
+   const JMSG_TOPIC_TBL_Topic_t *OtherTopic;
+
+   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); !Shared && i <= TOPIC_PART_Last(); i++)
+   {
+      OtherTopic = JMSG_TOPIC_TBL_GetTopic(i);
+      if (i != TopicPlugin && OtherTopic != NULL && OtherTopic->Cfe == Topic->Cfe)
+      {
+         Shared = true;
+      }
+   }
+
+   return Shared;
+
+} /* End SharesMsgId() */
+
+
+#ifdef JMSG_APP_TOPIC_CONV
+/******************************************************************************
+** Function: VerifyConv
+**
+** Compare the JSON member names written by a topic's generated converter
+** with the names written by the topic plugin's CfeToJson function. Returns
+** the converter if it can be used for the message or NULL if the topic
+** plugin must convert it.
+**
+** Notes:
+**   1. Called by the topic's protocol app for each message until the
+**      converter is verified so the topic plugin's JSON buffer is only
+**      written by the task that owns it.
+**   2. A converter whose member names differ is removed from the topic so
+**      the topic's JSON doesn't change when a converter is generated.
+**      TopicStatsTlm reports the rejection.
+**
+*/
+static const TOPIC_CONV_Conv_t *VerifyConv(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin, const TOPIC_CONV_Conv_t *Conv,
+                                           JMSG_TOPIC_TBL_CfeToJson_t PluginCfeToJson, const CFE_MSG_Message_t *CfeMsg)
+{
+
+   uint16 Idx = TopicPlugin - JMSG_PLATFORM_TopicPlugin_Enum_t_MIN;
+   const char *PluginJson;
+   const char *ConvJson;
+   const TOPIC_CONV_Conv_t *VerifiedConv = NULL;
+
+   if (PluginCfeToJson(&PluginJson, CfeMsg) && ConvertPayload(Conv, &ConvJson, CfeMsg))
+   {
+      if (TOPIC_CONV_SameKeys(PluginJson, ConvJson))
+      {
+         TopicHook->ConvVerified[Idx] = true;
+         VerifiedConv = Conv;
+      }
+      else
+      {
+         __atomic_store_n(&TopicHook->Conv[Idx], NULL, __ATOMIC_RELEASE);
+         __atomic_store_n(&TopicHook->ConvRejected[Idx], true, __ATOMIC_RELAXED);
+      }
+   }
+
+   return VerifiedConv;
+
+} /* End VerifyConv() */
+#endif
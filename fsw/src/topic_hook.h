@@ -0,0 +1,166 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Apply JMSG_APP's forwarding policy on the topic plugins' SB-to-JSON path
+**
+** Notes:
+**   1. JMSG_LIB is loaded before JMSG_APP so it can't call JMSG_APP
+**      functions by name. Instead each topic plugin's CfeToJson function
+**      registered in the JMSG topic table is replaced with a JMSG_APP
+**      function that calls TOPIC_FWD_ForwardSbMsg() and then the plugin's
+**      own CfeToJson function. The JMSG protocol apps call it from their
+**      tasks when they convert a SB message. A message that isn't forwarded
+**      is reported to the protocol app as a message that wasn't converted.
+**   2. CfeToJson functions only receive the SB message so the topic plugin
+**      is found using TOPIC_IDX_GetTopicPlugin(). Topic plugins in the
+**      partition that share a message ID can't be told apart and are not
+**      hooked.
+**   3. Only the topic plugins in this instance's partition are hooked. The
+**      USR_TPLUG owner instance must be started before the other instances
+**      because it constructs the topic plugins.
+**   4. The topic plugins' CfeToJson functions are restored when the app
+**      exits so JMSG_LIB never calls into an unloaded app module. If an
+**      instance is deleted without exiting its main loop the USR_TPLUG
+**      owner must be restarted so the topic plugins are reconstructed.
+**   5. When the build generates a converter for a topic plugin (see
+**      topic_conv.h) the hook converts the SB message payload with it
+**      instead of calling the topic plugin's CfeToJson function. Until a
+**      converter's JSON member names are verified against the topic
+**      plugin's JSON the topic plugin also converts each message. A
+**      converter with different member names isn't used.
+**   6. The hook applies the COMPACT_JSON encoding by copying the compacted
+**      JSON into a buffer owned by the topic. Like a topic plugin's own
+**      JSON buffer it is only written by the topic's protocol app task.
+**   7. Before a topic plugin is hooked the instance claims it by
+**      registering a cFE ES generic counter named with
+**      TOPIC_HOOK_CLAIM_NAME_FMT. Counter names are unique on a processor
+**      so a topic plugin whose CfeToJson function is another instance's
+**      hook is never hooked, and the hook is never saved as the topic
+**      plugin's own function. Once hooked, a topic plugin is only hooked
+**      again if its CfeToJson function is the saved one. The claim is
+**      released when the hook is removed.
+**
+*/
+
+#ifndef _topic_hook_
+#define _topic_hook_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "jmsg_topic_tbl.h"
+#include "topic_part.h"
+#include "topic_idx.h"
+#include "topic_fwd.h"
+#include "topic_conv.h"
+#include "topic_enc.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define TOPIC_HOOK_INSTALL_EID  (TOPIC_HOOK_BASE_EID + 0)
+
+#define TOPIC_HOOK_CLAIM_NAME_FMT  "JMSG_HOOK_%d"  /* Must fit in OS_MAX_API_NAME with the largest topic plugin ID */
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   uint16  HookedCnt;
+   uint16  ConvCnt;
+   CFE_ES_CounterId_t  ClaimId[JMSG_APP_TOPIC_PLUGIN_CNT];    /* Generic counter claiming the topic plugin */
+   bool                Claimed[JMSG_APP_TOPIC_PLUGIN_CNT];
+   JMSG_TOPIC_TBL_CfeToJson_t  CfeToJson[JMSG_APP_TOPIC_PLUGIN_CNT];  /* Topic plugin's own function, NULL if not hooked */
+   const TOPIC_CONV_Conv_t    *Conv[JMSG_APP_TOPIC_PLUGIN_CNT];       /* Generated converter, NULL if none            */
+   bool  ConvVerified[JMSG_APP_TOPIC_PLUGIN_CNT];  /* Converter's member names match the topic plugin's JSON */
+   bool  ConvRejected[JMSG_APP_TOPIC_PLUGIN_CNT];  /* Converter removed because its member names differ      */
+   char  CompactJson[JMSG_APP_TOPIC_PLUGIN_CNT][JMSG_APP_TOPIC_COMPACT_JSON_MAX_LEN];  /* COMPACT_JSON encoded payloads */
+
+} TOPIC_HOOK_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TOPIC_HOOK_Constructor
+**
+*/
+void TOPIC_HOOK_Constructor(TOPIC_HOOK_Class_t *TopicHookPtr);
+
+
+/******************************************************************************
+** Function: TOPIC_HOOK_ConvRejected
+**
+** Return true if a topic plugin's generated converter was removed because
+** its JSON member names differ from the topic plugin's JSON.
+**
+*/
+bool TOPIC_HOOK_ConvRejected(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_HOOK_Hooked
+**
+** Return true if the forwarding policy is applied to a topic plugin's SB
+** messages.
+**
+*/
+bool TOPIC_HOOK_Hooked(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_HOOK_Install
+**
+** Hook the CfeToJson functions of the partition's topic plugins.
+**
+** Notes:
+**   1. Must be called after the topic plugins are constructed and before
+**      the topics are announced to the JMSG protocol apps.
+**   2. A topic plugin is skipped if its CfeToJson function isn't the
+**      topic plugin's own function. See file prologue note 7.
+**
+*/
+void TOPIC_HOOK_Install(void);
+
+
+/******************************************************************************
+** Function: TOPIC_HOOK_Remove
+**
+** Restore the topic plugins' own CfeToJson functions.
+**
+*/
+void TOPIC_HOOK_Remove(void);
+
+
+#endif /* _topic_hook_ */
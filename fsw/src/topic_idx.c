@@ -0,0 +1,462 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the TOPIC_IDX class
+**
+** Notes:
+**   None
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "jmsg_topic_tbl.h"
+#include "seqlock.h"
+#include "topic_idx.h"
+
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+#define MID_INDEX_MASK  (JMSG_APP_MID_INDEX_SIZE - 1)
+
+#if (JMSG_APP_MID_INDEX_SIZE & MID_INDEX_MASK) != 0
+   #error JMSG_APP_MID_INDEX_SIZE must be a power of 2
+#endif
+
+/* Buffer selection from an index generation counter. See header note 3. */
+#define ACTIVE_BUF(Gen)    (((Gen) >> 1) & 1)
+#define INACTIVE_BUF(Gen)  ((((Gen) >> 1) + 1) & 1)
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static void   BuildMidTbl(void);
+static int    CompareName(const char *EntryName, const char *Name, size_t NameLen);
+static int    CompareNameEntry(const void *Entry1, const void *Entry2);
+static uint32 HashMsgId(uint32 MsgIdValue);
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static TOPIC_IDX_Class_t *TopicIdx;
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_Constructor
+**
+*/
+void TOPIC_IDX_Constructor(TOPIC_IDX_Class_t *TopicIdxPtr)
+{
+
+   TopicIdx = TopicIdxPtr;
+
+   memset((void*)TopicIdx, 0, sizeof(TOPIC_IDX_Class_t));
+
+} /* End TOPIC_IDX_Constructor() */
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_GetTopicPlugin
+**
+*/
+bool TOPIC_IDX_GetTopicPlugin(CFE_SB_MsgId_t MsgId, JMSG_PLATFORM_TopicPlugin_Enum_t *TopicPlugin)
+{
+
+   uint32 MsgIdValue = CFE_SB_MsgIdToValue(MsgId);
+   uint32 Gen;
+   uint32 Slot;
+   bool   Found;
+   const TOPIC_IDX_MidTbl_t   *MidTbl;
+   const TOPIC_IDX_MidEntry_t *Entry;
+
+   do
+   {
+
+      Gen    = __atomic_load_n(&TopicIdx->MidGen, __ATOMIC_ACQUIRE);
+      MidTbl = &TopicIdx->MidTbl[ACTIVE_BUF(Gen)];
+      Slot   = HashMsgId(MsgIdValue);
+      Found  = false;
+
+      for (uint16 Probe=0; Probe <= MidTbl->MaxProbeLen; Probe++)
+      {
+         Entry = &MidTbl->Entry[(Slot + Probe) & MID_INDEX_MASK];
+         if (!Entry->Used)
+         {
+            break;
+         }
+         if (Entry->MsgIdValue == MsgIdValue)
+         {
+            *TopicPlugin = Entry->TopicPlugin;
+            Found = true;
+            break;
+         }
+      }
+
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+   } while (__atomic_load_n(&TopicIdx->MidGen, __ATOMIC_RELAXED) != Gen);
+
+   return Found;
+
+} /* End TOPIC_IDX_GetTopicPlugin() */
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_GetTopicPluginByName
+**
+*/
+bool TOPIC_IDX_GetTopicPluginByName(const char *Name, size_t NameLen, JMSG_PLATFORM_TopicPlugin_Enum_t *TopicPlugin)
+{
+
+   uint32 Gen;
+   int    Low, High, Mid;
+   int    Result;
+   bool   Found;
+   const TOPIC_IDX_NameTbl_t *NameTbl;
+
+   do
+   {
+
+      Gen     = __atomic_load_n(&TopicIdx->NameGen, __ATOMIC_ACQUIRE);
+      NameTbl = &TopicIdx->NameTbl[ACTIVE_BUF(Gen)];
+      Low     = 0;
+      High    = (NameLen < JMSG_APP_TOPIC_NAME_MAX_LEN) ? (int)NameTbl->TopicCnt - 1 : -1;  /* Longer names aren't indexed */
+      Found   = false;
+
+      while (Low <= High)
+      {
+         Mid    = (Low + High) / 2;
+         Result = CompareName(NameTbl->Entry[Mid].Name, Name, NameLen);
+         if (Result == 0)
+         {
+            *TopicPlugin = NameTbl->Entry[Mid].TopicPlugin;
+            Found = true;
+            break;
+         }
+         else if (Result < 0)
+         {
+            Low = Mid + 1;
+         }
+         else
+         {
+            High = Mid - 1;
+         }
+      }
+
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+   } while (__atomic_load_n(&TopicIdx->NameGen, __ATOMIC_RELAXED) != Gen);
+
+   return Found;
+
+} /* End TOPIC_IDX_GetTopicPluginByName() */
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_LoadTopicTblCmd
+**
+*/
+bool TOPIC_IDX_LoadTopicTblCmd(APP_C_FW_TblLoadOptions_Enum_t LoadType, const char *Filename)
+{
+
+   bool RetStatus = JMSG_TOPIC_TBL_LoadCmd(LoadType, Filename);
+
+   if (RetStatus)
+   {
+      TOPIC_IDX_Rebuild();
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_IDX_LoadTopicTblCmd() */
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_RejectTopicTblLoadCmd
+**
+*/
+bool TOPIC_IDX_RejectTopicTblLoadCmd(APP_C_FW_TblLoadOptions_Enum_t LoadType, const char *Filename)
+{
+
+   EVT_LIM_SendEvent(TOPIC_IDX_LOAD_TBL_EID, EVT_LIM_NO_TOPIC, CFE_EVS_EventType_ERROR,
+                     "JMSG topic table load of %s rejected. Only the USR_TPLUG owner instance loads the table",
+                     Filename);
+
+   return false;
+
+} /* End TOPIC_IDX_RejectTopicTblLoadCmd() */
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_Rebuild
+**
+*/
+void TOPIC_IDX_Rebuild(void)
+{
+
+   uint16 LongNameCnt = 0;
+   TOPIC_IDX_NameTbl_t   *NameTbl = &TopicIdx->NameTbl[INACTIVE_BUF(TopicIdx->NameGen)];
+   TOPIC_IDX_NameEntry_t *Entry;
+   const JMSG_TOPIC_TBL_Topic_t *Topic;
+
+   BuildMidTbl();
+
+   SEQLOCK_WriteBegin(&TopicIdx->NameGen);
+   NameTbl->TopicCnt = 0;
+   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); i <= TOPIC_PART_Last(); i++)
+   {
+
+      Topic = JMSG_TOPIC_TBL_GetTopic(i);
+      if (Topic == NULL || !Topic->Enabled)
+      {
+         continue;
+      }
+
+      if (strlen(Topic->Name) < JMSG_APP_TOPIC_NAME_MAX_LEN)
+      {
+         Entry = &NameTbl->Entry[NameTbl->TopicCnt++];
+         Entry->TopicPlugin = i;
+         strcpy(Entry->Name, Topic->Name);
+      }
+      else
+      {
+         LongNameCnt++;
+      }
+
+   } /* End topic plugin loop */
+
+   qsort(NameTbl->Entry, NameTbl->TopicCnt, sizeof(TOPIC_IDX_NameEntry_t), CompareNameEntry);
+   SEQLOCK_WriteEnd(&TopicIdx->NameGen);
+
+   if (LongNameCnt > 0)
+   {
+      EVT_LIM_SendEvent(TOPIC_IDX_REBUILD_EID, EVT_LIM_NO_TOPIC, CFE_EVS_EventType_ERROR,
+                        "Name index rebuilt with %d topic plugins. %d topic names exceed the %d character limit and aren't indexed",
+                        NameTbl->TopicCnt, LongNameCnt, (JMSG_APP_TOPIC_NAME_MAX_LEN - 1));
+   }
+
+} /* End TOPIC_IDX_Rebuild() */
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_UpdateTopic
+**
+** Notes:
+**   1. The active name index is copied to the inactive buffer with the
+**      topic plugin removed and, if it's enabled, inserted at its sorted
+**      position. This avoids sorting the index for each command.
+**
+*/
+void TOPIC_IDX_UpdateTopic(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   bool   Insert;
+   const TOPIC_IDX_NameTbl_t *SrcTbl = &TopicIdx->NameTbl[ACTIVE_BUF(TopicIdx->NameGen)];
+   TOPIC_IDX_NameTbl_t       *DstTbl = &TopicIdx->NameTbl[INACTIVE_BUF(TopicIdx->NameGen)];
+   const TOPIC_IDX_NameEntry_t  *SrcEntry;
+   const JMSG_TOPIC_TBL_Topic_t *Topic = JMSG_TOPIC_TBL_GetTopic(TopicPlugin);
+
+   if (Topic == NULL || !TOPIC_PART_Contains(TopicPlugin))
+   {
+      return;
+   }
+
+   BuildMidTbl();
+
+   Insert = Topic->Enabled && (strlen(Topic->Name) < JMSG_APP_TOPIC_NAME_MAX_LEN);
+
+   SEQLOCK_WriteBegin(&TopicIdx->NameGen);
+   DstTbl->TopicCnt = 0;
+   for (uint16 i=0; i < SrcTbl->TopicCnt; i++)
+   {
+
+      SrcEntry = &SrcTbl->Entry[i];
+      if (SrcEntry->TopicPlugin == TopicPlugin)
+      {
+         continue;
+      }
+
+      if (Insert && strcmp(SrcEntry->Name, Topic->Name) > 0)
+      {
+         DstTbl->Entry[DstTbl->TopicCnt].TopicPlugin = TopicPlugin;
+         strcpy(DstTbl->Entry[DstTbl->TopicCnt++].Name, Topic->Name);
+         Insert = false;
+      }
+      DstTbl->Entry[DstTbl->TopicCnt++] = *SrcEntry;
+
+   } /* End name entry loop */
+
+   if (Insert)
+   {
+      DstTbl->Entry[DstTbl->TopicCnt].TopicPlugin = TopicPlugin;
+      strcpy(DstTbl->Entry[DstTbl->TopicCnt++].Name, Topic->Name);
+   }
+
+   SEQLOCK_WriteEnd(&TopicIdx->NameGen);
+
+} /* End TOPIC_IDX_UpdateTopic() */
+
+
+/******************************************************************************
+** Function: BuildMidTbl
+**
+** Build the message ID index in the inactive buffer and publish it.
+**
+** Notes:
+**   1. Topic plugins are added in ID order so the lowest ID wins when a
+**      message ID is shared.
+**   2. The index is sized for a load factor of at most 50% so the table
+**      can't fill unless JMSG_APP_MID_INDEX_SIZE is misconfigured.
+**
+*/
+static void BuildMidTbl(void)
+{
+
+   uint32 MsgIdValue;
+   uint32 Slot;
+   uint16 Probe;
+   uint16 FullCnt = 0;
+   TOPIC_IDX_MidTbl_t   *MidTbl = &TopicIdx->MidTbl[INACTIVE_BUF(TopicIdx->MidGen)];
+   TOPIC_IDX_MidEntry_t *Entry;
+   const JMSG_TOPIC_TBL_Topic_t *Topic;
+
+   SEQLOCK_WriteBegin(&TopicIdx->MidGen);
+   memset((void*)MidTbl, 0, sizeof(TOPIC_IDX_MidTbl_t));
+   TopicIdx->DupMidCnt = 0;
+
+   for (JMSG_PLATFORM_TopicPlugin_Enum_t i=TOPIC_PART_First(); i <= TOPIC_PART_Last(); i++)
+   {
+
+      Topic = JMSG_TOPIC_TBL_GetTopic(i);
+      if (Topic == NULL || !Topic->Enabled)
+      {
+         continue;
+      }
+
+      MsgIdValue = CFE_SB_MsgIdToValue(CFE_SB_ValueToMsgId(Topic->Cfe));
+      Slot = HashMsgId(MsgIdValue);
+
+      for (Probe=0; Probe < JMSG_APP_MID_INDEX_SIZE; Probe++)
+      {
+         Entry = &MidTbl->Entry[(Slot + Probe) & MID_INDEX_MASK];
+         if (!Entry->Used || Entry->MsgIdValue == MsgIdValue)
+         {
+            break;
+         }
+      }
+
+      if (Probe == JMSG_APP_MID_INDEX_SIZE)
+      {
+         FullCnt++;
+      }
+      else if (Entry->Used)
+      {
+         TopicIdx->DupMidCnt++;
+      }
+      else
+      {
+         Entry->Used        = true;
+         Entry->TopicPlugin = i;
+         Entry->MsgIdValue  = MsgIdValue;
+         MidTbl->TopicCnt++;
+         if (Probe > MidTbl->MaxProbeLen)
+         {
+            MidTbl->MaxProbeLen = Probe;
+         }
+      }
+
+   } /* End topic plugin loop */
+
+   SEQLOCK_WriteEnd(&TopicIdx->MidGen);
+
+   if (FullCnt > 0 || TopicIdx->DupMidCnt > 0)
+   {
+      EVT_LIM_SendEvent(TOPIC_IDX_REBUILD_EID, EVT_LIM_NO_TOPIC, CFE_EVS_EventType_ERROR,
+                        "Message ID index rebuilt with %d topic plugins. %d shared message IDs and %d topic plugins not indexed because the index is full",
+                        MidTbl->TopicCnt, TopicIdx->DupMidCnt, FullCnt);
+   }
+   else
+   {
+      CFE_EVS_SendEvent(TOPIC_IDX_REBUILD_EID, CFE_EVS_EventType_DEBUG,
+                        "Message ID index rebuilt with %d topic plugins, maximum probe length %d",
+                        MidTbl->TopicCnt, MidTbl->MaxProbeLen);
+   }
+
+} /* End BuildMidTbl() */
+
+
+/******************************************************************************
+** Function: CompareName
+**
+** Compare an indexed name with a name that may not be null terminated. The
+** order matches strcmp().
+**
+** Notes:
+**   1. NameLen must be less than JMSG_APP_TOPIC_NAME_MAX_LEN so the entry's
+**      name buffer isn't read past its end.
+**
+*/
+static int CompareName(const char *EntryName, const char *Name, size_t NameLen)
+{
+
+   int Result = strncmp(EntryName, Name, NameLen);
+
+   if (Result == 0 && EntryName[NameLen] != '\0')
+   {
+      Result = 1;
+   }
+
+   return Result;
+
+} /* End CompareName() */
+
+
+/******************************************************************************
+** Function: CompareNameEntry
+**
+** qsort() comparison function
+**
+*/
+static int CompareNameEntry(const void *Entry1, const void *Entry2)
+{
+
+   return strcmp(((const TOPIC_IDX_NameEntry_t *)Entry1)->Name, ((const TOPIC_IDX_NameEntry_t *)Entry2)->Name);
+
+} /* End CompareNameEntry() */
+
+
+/******************************************************************************
+** Function: HashMsgId
+**
+** Multiplicative hash of a message ID value to a starting index slot.
+** Multiplying by an odd constant keeps consecutive message IDs in
+** different slots.
+*/
+static uint32 HashMsgId(uint32 MsgIdValue)
+{
+
+   return (MsgIdValue * 2654435761u) & MID_INDEX_MASK;
+
+} /* End HashMsgId() */
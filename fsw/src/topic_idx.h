@@ -0,0 +1,240 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Index the enabled topic plugins by message ID and topic name
+**
+** Notes:
+**   1. The message ID index only serves the topic plugin CfeToJson hook
+**      (see topic_hook.h). The hook only receives the SB message so it
+**      calls TOPIC_IDX_GetTopicPlugin() to find the topic plugin that owns
+**      the message ID rather than scanning the topic table. The protocol
+**      apps still find the topic plugin with their own topic table search
+**      before they call the hook, so the index adds a lookup to each
+**      message rather than replacing the protocol app's search. JMSG_LIB
+**      can't call JMSG_APP functions so it can't use the index.
+**      TOPIC_IDX_GetTopicPluginByName() finds the topic plugin for a JSON
+**      topic name. Its only user is the loopback test's return path, which
+**      uses it to return the entries of an echoed JSON frame. The protocol
+**      apps' inbound JSON-to-SB path isn't hooked because JMSG_LIB doesn't
+**      pass the topic name to JsonToCfe functions. The message ID
+**      index is an open addressing hash table with linear probing. The name
+**      index is an array sorted by name that is binary searched.
+**   2. The indices contain the enabled topic plugins in this instance's
+**      partition. They are rebuilt by the JMSG_APP task when the JMSG topic
+**      table is loaded. When a topic plugin is enabled or disabled the
+**      message ID index is rebuilt and the topic is inserted into or
+**      removed from a copy of the name index. If more than one topic plugin
+**      uses a message ID the lowest topic plugin ID is indexed.
+**   3. Each index is double buffered. An update fills the inactive buffer
+**      between SEQLOCK_WriteBegin() and SEQLOCK_WriteEnd() on the index's
+**      generation counter. The counter is odd while a buffer is built and
+**      is incremented by 2 for each build, so the active buffer is
+**      selected by the counter's second bit. A lookup is repeated if the
+**      generation changed while it was reading so lookups never block and
+**      never use a partially built buffer.
+**
+*/
+
+#ifndef _topic_idx_
+#define _topic_idx_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+#include "topic_part.h"
+#include "evt_lim.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define TOPIC_IDX_REBUILD_EID   (TOPIC_IDX_BASE_EID + 0)
+#define TOPIC_IDX_LOAD_TBL_EID  (TOPIC_IDX_BASE_EID + 1)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Message ID index entry
+*/
+
+typedef struct
+{
+
+   bool    Used;
+   uint16  TopicPlugin;
+   uint32  MsgIdValue;
+
+} TOPIC_IDX_MidEntry_t;
+
+
+/******************************************************************************
+** Message ID index buffer
+*/
+
+typedef struct
+{
+
+   uint16  TopicCnt;
+   uint16  MaxProbeLen;
+   TOPIC_IDX_MidEntry_t  Entry[JMSG_APP_MID_INDEX_SIZE];
+
+} TOPIC_IDX_MidTbl_t;
+
+
+/******************************************************************************
+** Name index entry
+*/
+
+typedef struct
+{
+
+   uint16  TopicPlugin;
+   char    Name[JMSG_APP_TOPIC_NAME_MAX_LEN];
+
+} TOPIC_IDX_NameEntry_t;
+
+
+/******************************************************************************
+** Name index buffer sorted by name
+*/
+
+typedef struct
+{
+
+   uint16  TopicCnt;
+   TOPIC_IDX_NameEntry_t  Entry[JMSG_APP_TOPIC_PLUGIN_CNT];
+
+} TOPIC_IDX_NameTbl_t;
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   uint32  MidGen;     /* Active buffer is MidTbl[(MidGen >> 1) & 1], odd while a buffer is built */
+   uint16  DupMidCnt;  /* Topic plugins not indexed by the last rebuild because their message ID was already indexed */
+   TOPIC_IDX_MidTbl_t  MidTbl[2];
+
+   uint32  NameGen;    /* Active buffer is NameTbl[(NameGen >> 1) & 1], odd while a buffer is built */
+   TOPIC_IDX_NameTbl_t  NameTbl[2];
+
+} TOPIC_IDX_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_Constructor
+**
+** Notes:
+**   1. Must be called before the JMSG topic table is registered because
+**      the USR_TPLUG owner loads the table when it is registered.
+**
+*/
+void TOPIC_IDX_Constructor(TOPIC_IDX_Class_t *TopicIdxPtr);
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_GetTopicPlugin
+**
+** Return true and the topic plugin that owns a SB message ID if the message
+** ID is indexed.
+**
+** Notes:
+**   1. Called from protocol app tasks by the topic plugin CfeToJson hook.
+**
+*/
+bool TOPIC_IDX_GetTopicPlugin(CFE_SB_MsgId_t MsgId, JMSG_PLATFORM_TopicPlugin_Enum_t *TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_GetTopicPluginByName
+**
+** Return true and the topic plugin for a JSON topic name if the name is
+** indexed.
+**
+** Notes:
+**   1. Called from the loopback test's child task.
+**   2. Name doesn't need to be null terminated so a name can be passed
+**      directly from a received JSON message. A name that is too long to be
+**      indexed isn't found.
+**
+*/
+bool TOPIC_IDX_GetTopicPluginByName(const char *Name, size_t NameLen, JMSG_PLATFORM_TopicPlugin_Enum_t *TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_LoadTopicTblCmd
+**
+** Load the JMSG topic table and rebuild the index.
+**
+** Notes:
+**  1. Function signature must match TBLMGR_LoadTblFuncPtr_t.
+**
+*/
+bool TOPIC_IDX_LoadTopicTblCmd(APP_C_FW_TblLoadOptions_Enum_t LoadType, const char *Filename);
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_RejectTopicTblLoadCmd
+**
+** Reject a JMSG topic table load in an instance that isn't the USR_TPLUG
+** owner.
+**
+** Notes:
+**  1. Function signature must match TBLMGR_LoadTblFuncPtr_t.
+**  2. JMSG_LIB has one JMSG topic table so only the owner loads it. After the
+**     owner loads a new table the other instances must be restarted to
+**     rebuild their indices.
+**
+*/
+bool TOPIC_IDX_RejectTopicTblLoadCmd(APP_C_FW_TblLoadOptions_Enum_t LoadType, const char *Filename);
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_Rebuild
+**
+** Rebuild the indices from the JMSG topic table's enabled topic plugins.
+**
+*/
+void TOPIC_IDX_Rebuild(void);
+
+
+/******************************************************************************
+** Function: TOPIC_IDX_UpdateTopic
+**
+** Update the indices after a topic plugin has been enabled or disabled.
+**
+*/
+void TOPIC_IDX_UpdateTopic(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+#endif /* _topic_idx_ */
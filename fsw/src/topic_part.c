@@ -0,0 +1,109 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the topic plugin partition
+**
+** Notes:
+**   None
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "topic_part.h"
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static TOPIC_PART_Class_t *TopicPart;
+
+
+/******************************************************************************
+** Function: TOPIC_PART_Constructor
+**
+*/
+bool TOPIC_PART_Constructor(TOPIC_PART_Class_t *TopicPartPtr, const INITBL_Class_t *IniTbl)
+{
+
+   bool   RetStatus = false;
+   uint32 First = INITBL_GetIntConfig(IniTbl, CFG_TOPIC_PLUGIN_FIRST);
+   uint32 Last  = INITBL_GetIntConfig(IniTbl, CFG_TOPIC_PLUGIN_LAST);
+
+   TopicPart = TopicPartPtr;
+
+   memset((void*)TopicPart, 0, sizeof(TOPIC_PART_Class_t));
+
+   if (Last > JMSG_PLATFORM_TopicPlugin_Enum_t_MAX)
+   {
+      Last = JMSG_PLATFORM_TopicPlugin_Enum_t_MAX;
+   }
+
+   if (First >= JMSG_PLATFORM_TopicPlugin_Enum_t_MIN && First <= Last)
+   {
+      TopicPart->First = First;
+      TopicPart->Last  = Last;
+      RetStatus = true;
+   }
+   else
+   {
+      CFE_EVS_SendEvent(TOPIC_PART_CONSTRUCTOR_EID, CFE_EVS_EventType_ERROR,
+                        "Invalid topic plugin partition %u..%u, valid IDs are %d..%d",
+                        First, Last, JMSG_PLATFORM_TopicPlugin_Enum_t_MIN, JMSG_PLATFORM_TopicPlugin_Enum_t_MAX);
+   }
+
+   return RetStatus;
+
+} /* End TOPIC_PART_Constructor() */
+
+
+/******************************************************************************
+** Function: TOPIC_PART_Contains
+**
+*/
+bool TOPIC_PART_Contains(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin)
+{
+
+   return (TopicPlugin >= TopicPart->First && TopicPlugin <= TopicPart->Last);
+
+} /* End TOPIC_PART_Contains() */
+
+
+/******************************************************************************
+** Function: TOPIC_PART_First
+**
+*/
+JMSG_PLATFORM_TopicPlugin_Enum_t TOPIC_PART_First(void)
+{
+
+   return TopicPart->First;
+
+} /* End TOPIC_PART_First() */
+
+
+/******************************************************************************
+** Function: TOPIC_PART_Last
+**
+*/
+JMSG_PLATFORM_TopicPlugin_Enum_t TOPIC_PART_Last(void)
+{
+
+   return TopicPart->Last;
+
+} /* End TOPIC_PART_Last() */
@@ -0,0 +1,113 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Define the partition of topic plugins owned by a JMSG_APP instance
+**
+** Notes:
+**   1. Multiple JMSG_APP instances can share the topic plugins. Each
+**      instance owns the contiguous range of topic plugin IDs defined by
+**      the TOPIC_PLUGIN_FIRST and TOPIC_PLUGIN_LAST ini configurations.
+**      Topic subscription broadcasts, topic commands, tests and topic
+**      statistics only operate on the instance's partition.
+**   2. Each instance reads the ini file named after its cFE app name. See
+**      JMSG_APP_INI_FILENAME_FMT in jmsg_app_platform_cfg.h. The ini file
+**      must define a unique APP_CFE_NAME, topic IDs, pipe names and
+**      loopback test ports.
+**   3. Partitions must not overlap. Overlaps can't be detected because the
+**      instances don't know about each other.
+**
+*/
+
+#ifndef _topic_part_
+#define _topic_part_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define TOPIC_PART_CONSTRUCTOR_EID  (TOPIC_PART_BASE_EID + 0)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   JMSG_PLATFORM_TopicPlugin_Enum_t  First;
+   JMSG_PLATFORM_TopicPlugin_Enum_t  Last;
+
+} TOPIC_PART_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: TOPIC_PART_Constructor
+**
+** Notes:
+**   1. The partition is limited to the JMSG_PLATFORM/TopicPlugin IDs so a
+**      large TOPIC_PLUGIN_LAST selects the remaining topic plugins.
+**   2. Returns false if the partition is empty or starts before the first
+**      topic plugin ID. The app must not start with an invalid partition
+**      because it could overlap another instance's partition.
+**
+*/
+bool TOPIC_PART_Constructor(TOPIC_PART_Class_t *TopicPartPtr, const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: TOPIC_PART_Contains
+**
+** Return true if the topic plugin is owned by this instance.
+**
+*/
+bool TOPIC_PART_Contains(JMSG_PLATFORM_TopicPlugin_Enum_t TopicPlugin);
+
+
+/******************************************************************************
+** Function: TOPIC_PART_First
+**
+*/
+JMSG_PLATFORM_TopicPlugin_Enum_t TOPIC_PART_First(void);
+
+
+/******************************************************************************
+** Function: TOPIC_PART_Last
+**
+*/
+JMSG_PLATFORM_TopicPlugin_Enum_t TOPIC_PART_Last(void);
+
+
+#endif /* _topic_part_ */
@@ -0,0 +1,224 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Implement the per wakeup time budget
+**
+** Notes:
+**   1. Only the first overrun after a reset generates an event message so a
+**      heavily loaded processor isn't also flooded with events. Use the
+**      overrun count in the status telemetry to monitor overruns.
+**
+*/
+
+/*
+** Include Files:
+*/
+
+#include <string.h>
+#include "wakeup_budget.h"
+
+
+/*******************************/
+/** Local Function Prototypes **/
+/*******************************/
+
+static uint32 BusyUsec(void);
+static uint32 ElapsedUsec(void);
+
+
+/**********************/
+/** File Global Data **/
+/**********************/
+
+static WAKEUP_BUDGET_Class_t *WakeupBudget;
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_Constructor
+**
+*/
+void WAKEUP_BUDGET_Constructor(WAKEUP_BUDGET_Class_t *WakeupBudgetPtr, const INITBL_Class_t *IniTbl)
+{
+
+   WakeupBudget = WakeupBudgetPtr;
+
+   memset((void*)WakeupBudget, 0, sizeof(WAKEUP_BUDGET_Class_t));
+
+   WakeupBudget->BudgetUsec    = INITBL_GetIntConfig(IniTbl, CFG_WAKEUP_BUDGET);
+   WakeupBudget->WallLimitUsec = INITBL_GetIntConfig(IniTbl, CFG_WAKEUP_WALL_LIMIT) * 1000;
+
+} /* End WAKEUP_BUDGET_Constructor() */
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_Defer
+**
+*/
+void WAKEUP_BUDGET_Defer(void)
+{
+
+   WakeupBudget->Deferred = true;
+
+} /* End WAKEUP_BUDGET_Defer() */
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_Delay
+**
+*/
+void WAKEUP_BUDGET_Delay(uint32 DelayMs)
+{
+
+   OS_time_t  DelayStartTime;
+   OS_time_t  DelayEndTime;
+
+   OS_GetLocalTime(&DelayStartTime);
+   OS_TaskDelay(DelayMs);
+   OS_GetLocalTime(&DelayEndTime);
+
+   WakeupBudget->DelayUsec += (uint32)OS_TimeGetTotalMicroseconds(OS_TimeSubtract(DelayEndTime, DelayStartTime));
+
+} /* End WAKEUP_BUDGET_Delay() */
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_End
+**
+*/
+void WAKEUP_BUDGET_End(void)
+{
+
+   if (!WakeupBudget->InWakeup)
+   {
+      return;
+   }
+
+   WakeupBudget->LastBusyUsec = BusyUsec();
+   if (WakeupBudget->LastBusyUsec > WakeupBudget->MaxBusyUsec)
+   {
+      WakeupBudget->MaxBusyUsec = WakeupBudget->LastBusyUsec;
+   }
+
+   if (WakeupBudget->Deferred)
+   {
+      WakeupBudget->DeferredCnt++;
+   }
+
+   if (WakeupBudget->BudgetUsec > 0 && WakeupBudget->LastBusyUsec > WakeupBudget->BudgetUsec)
+   {
+      if (WakeupBudget->OverrunCnt == 0)
+      {
+         CFE_EVS_SendEvent(WAKEUP_BUDGET_OVERRUN_EID, CFE_EVS_EventType_INFORMATION,
+                           "Wakeup processing time %u usec exceeded the %u usec budget",
+                           WakeupBudget->LastBusyUsec, WakeupBudget->BudgetUsec);
+      }
+      WakeupBudget->OverrunCnt++;
+   }
+
+   WakeupBudget->InWakeup = false;
+
+} /* End WAKEUP_BUDGET_End() */
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_Exhausted
+**
+*/
+bool WAKEUP_BUDGET_Exhausted(void)
+{
+
+   return (WakeupBudget->InWakeup &&
+           ((WakeupBudget->BudgetUsec > 0 && BusyUsec() >= WakeupBudget->BudgetUsec) ||
+            (WakeupBudget->WallLimitUsec > 0 && ElapsedUsec() >= WakeupBudget->WallLimitUsec)));
+
+} /* End WAKEUP_BUDGET_Exhausted() */
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_GetStats
+**
+*/
+void WAKEUP_BUDGET_GetStats(uint32 *LastBusyUsec, uint32 *MaxBusyUsec, uint32 *OverrunCnt, uint32 *DeferredCnt)
+{
+
+   *LastBusyUsec = WakeupBudget->LastBusyUsec;
+   *MaxBusyUsec  = WakeupBudget->MaxBusyUsec;
+   *OverrunCnt   = WakeupBudget->OverrunCnt;
+   *DeferredCnt  = WakeupBudget->DeferredCnt;
+
+} /* End WAKEUP_BUDGET_GetStats() */
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_ResetStatus
+**
+*/
+void WAKEUP_BUDGET_ResetStatus(void)
+{
+
+   WakeupBudget->MaxBusyUsec = 0;
+   WakeupBudget->OverrunCnt  = 0;
+   WakeupBudget->DeferredCnt = 0;
+
+} /* End WAKEUP_BUDGET_ResetStatus() */
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_Start
+**
+*/
+void WAKEUP_BUDGET_Start(void)
+{
+
+   OS_GetLocalTime(&WakeupBudget->WakeupStartTime);
+   WakeupBudget->DelayUsec = 0;
+   WakeupBudget->Deferred  = false;
+   WakeupBudget->InWakeup  = true;
+
+} /* End WAKEUP_BUDGET_Start() */
+
+
+/******************************************************************************
+** Function: BusyUsec
+**
+** Return the time spent processing the current wakeup excluding delays.
+**
+*/
+static uint32 BusyUsec(void)
+{
+
+   uint32 WakeupUsec = ElapsedUsec();
+
+   return (WakeupUsec > WakeupBudget->DelayUsec) ? (WakeupUsec - WakeupBudget->DelayUsec) : 0;
+
+} /* End BusyUsec() */
+
+
+/******************************************************************************
+** Function: ElapsedUsec
+**
+** Return the time since the current wakeup started including delays.
+**
+*/
+static uint32 ElapsedUsec(void)
+{
+
+   OS_time_t  CurrentTime;
+
+   OS_GetLocalTime(&CurrentTime);
+
+   return (uint32)OS_TimeGetTotalMicroseconds(OS_TimeSubtract(CurrentTime, WakeupBudget->WakeupStartTime));
+
+} /* End ElapsedUsec() */
@@ -0,0 +1,162 @@
+/*
+** Copyright 2022 bitValence, Inc.
+** All Rights Reserved.
+**
+** This program is free software; you can modify and/or redistribute it
+** under the terms of the GNU Affero General Public License
+** as published by the Free Software Foundation; version 3 with
+** attribution addendums as found in the LICENSE.txt
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Affero General Public License for more details.
+**
+** Purpose:
+**   Limit the time JMSG_APP spends on each scheduler wakeup
+**
+** Notes:
+**   1. The budget is the elapsed time JMSG_APP may spend processing a
+**      wakeup excluding time it's suspended by WAKEUP_BUDGET_Delay(). It is
+**      set by the WAKEUP_BUDGET ini configuration. A budget of 0 disables
+**      the limit. OSAL doesn't provide per task CPU time so this is wall
+**      clock time and includes time the task is preempted by higher
+**      priority tasks. On a loaded processor the budget is reached with
+**      less CPU time used.
+**   2. The wall limit is the elapsed time including delays. It is set by
+**      the WAKEUP_WALL_LIMIT ini configuration in milliseconds and bounds
+**      how long the command pipe isn't read, for example by a broadcast
+**      that delays between topics. A limit of 0 disables it.
+**   3. Deferrable work (topic tests and topic subscription broadcasts)
+**      checks WAKEUP_BUDGET_Exhausted() before each step and resumes at
+**      the next wakeup when the budget or the wall limit has been used.
+**      Telemetry is always sent.
+**   4. A wakeup that exceeds its budget is counted as an overrun. This
+**      happens when a step that can't be divided takes longer than the
+**      budget that remained.
+**   5. WAKEUP_BUDGET_Exhausted() returns false outside of a wakeup so
+**      work done during initialization or by commands isn't limited.
+**
+*/
+
+#ifndef _wakeup_budget_
+#define _wakeup_budget_
+
+/*
+** Includes
+*/
+
+#include "app_cfg.h"
+
+/***********************/
+/** Macro Definitions **/
+/***********************/
+
+/*
+** Event Message IDs
+*/
+
+#define WAKEUP_BUDGET_OVERRUN_EID  (WAKEUP_BUDGET_BASE_EID + 0)
+
+
+/**********************/
+/** Type Definitions **/
+/**********************/
+
+
+/******************************************************************************
+** Class
+*/
+
+typedef struct
+{
+
+   uint32     BudgetUsec;
+   uint32     WallLimitUsec;
+
+   bool       InWakeup;
+   bool       Deferred;
+   OS_time_t  WakeupStartTime;
+   uint32     DelayUsec;
+
+   uint32     LastBusyUsec;
+   uint32     MaxBusyUsec;
+   uint32     OverrunCnt;
+   uint32     DeferredCnt;
+
+} WAKEUP_BUDGET_Class_t;
+
+
+/************************/
+/** Exported Functions **/
+/************************/
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_Constructor
+**
+*/
+void WAKEUP_BUDGET_Constructor(WAKEUP_BUDGET_Class_t *WakeupBudgetPtr, const INITBL_Class_t *IniTbl);
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_Defer
+**
+** Record that work was deferred to the next wakeup.
+**
+*/
+void WAKEUP_BUDGET_Defer(void);
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_Delay
+**
+** Suspend the task without charging the suspended time to the budget.
+**
+*/
+void WAKEUP_BUDGET_Delay(uint32 DelayMs);
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_End
+**
+** Must be called when JMSG_APP finishes processing a wakeup.
+**
+*/
+void WAKEUP_BUDGET_End(void);
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_Exhausted
+**
+** Return true if deferrable work should wait for the next wakeup because
+** the budget or the wall limit has been used.
+**
+*/
+bool WAKEUP_BUDGET_Exhausted(void);
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_GetStats
+**
+*/
+void WAKEUP_BUDGET_GetStats(uint32 *LastBusyUsec, uint32 *MaxBusyUsec, uint32 *OverrunCnt, uint32 *DeferredCnt);
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_ResetStatus
+**
+*/
+void WAKEUP_BUDGET_ResetStatus(void);
+
+
+/******************************************************************************
+** Function: WAKEUP_BUDGET_Start
+**
+** Must be called when JMSG_APP starts processing a wakeup.
+**
+*/
+void WAKEUP_BUDGET_Start(void);
+
+
+#endif /* _wakeup_budget_ */
@@ -0,0 +1,395 @@
+#!/usr/bin/env python3
+"""
+    Copyright 2022 bitValence, Inc.
+    All Rights Reserved.
+
+    This program is free software; you can modify and/or redistribute it
+    under the terms of the GNU Affero General Public License
+    as published by the Free Software Foundation; version 3 with
+    attribution addendums as found in the LICENSE.txt.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    Purpose:
+      Generate static JSON<->SB payload converters from EDS container
+      definitions.
+
+    Notes:
+      1. Each converter spec has the form [TopicLabel=]PKG/Container. The
+         optional TopicLabel is a JMSG_PLATFORM/TopicPlugin enumeration label
+         that TOPIC_CONV_GetTopicConv() maps to the converter. A converter
+         assigned to a topic plugin gets a static JSON buffer that
+         TOPIC_HOOK uses in place of the topic plugin's CfeToJson function.
+         JSON member names are the EDS entry names. TOPIC_HOOK compares them
+         with the topic plugin's JSON and doesn't use a converter whose
+         names differ.
+      2. The serializer is a sequence of appends with one format string for
+         each run of scalar fields. The deserializer reads members in the
+         order the serializer writes them and only falls back to a keyed
+         search when a member is out of order. See topic_conv.h.
+      3. Only the SB-to-JSON serializer is used in flight. Received JSON
+         messages are still converted by the topic plugin's JsonToCfe
+         function. The deserializer is used by the benchmark.
+      4. Every entry type must be defined in an EDS file passed with -e
+         except for the BASE_TYPES numeric and string types listed below.
+         The generated code doesn't depend on integer sizes because
+         assignments are checked by reading the field back.
+      5. The '--bench' descriptor tables are only compiled when
+         TOPIC_CONV_BENCH is defined.
+
+    Usage:
+      topic_conv_gen.py -o <out_dir> -e <eds.xml> [-e <eds.xml>...] spec...
+
+"""
+
+import argparse
+import os
+import sys
+import xml.etree.ElementTree as ET
+
+GEN_BASENAME = 'topic_conv_gen'
+
+BASE_TYPES = {
+    'uint8': 'uint', 'uint16': 'uint', 'uint32': 'uint', 'uint64': 'uint',
+    'int8': 'int', 'int16': 'int', 'int32': 'int', 'int64': 'int',
+    'float': 'float', 'double': 'double',
+    'PathName': 'string', 'FileName': 'string', 'ApiName': 'string',
+}
+
+
+class Field:
+    """A JSON member or array element generated from an EDS entry."""
+
+    def __init__(self, name, kind, children=None, elem=None, dim=0):
+        self.name = name          # EDS entry name, JSON member name
+        self.kind = kind          # uint, int, enum, float, double, string, container, array
+        self.children = children  # container fields
+        self.elem = elem          # array element field (name is unused)
+        self.dim = dim            # array dimension
+
+
+class EdsDb:
+    """EDS data types indexed by package and name."""
+
+    def __init__(self):
+        self.types = {}
+
+    def load(self, filename):
+        for elem in ET.parse(filename).getroot().iter():
+            if strip_ns(elem.tag) == 'Package':
+                pkg = elem.get('name')
+                for dtype in elem.iter():
+                    if strip_ns(dtype.tag).endswith('DataType') and dtype.get('name'):
+                        self.types[(pkg, dtype.get('name'))] = dtype
+
+    def resolve(self, pkg, type_ref, path):
+        if '/' in type_ref:
+            pkg, name = type_ref.split('/', 1)
+        else:
+            name = type_ref
+
+        dtype = self.types.get((pkg, name))
+
+        if dtype is None:
+            if pkg == 'BASE_TYPES':
+                if name not in BASE_TYPES:
+                    sys.exit('%s: unsupported type BASE_TYPES/%s' % (path, name))
+                return BASE_TYPES[name], None
+            sys.exit('%s: type %s/%s is not defined in the EDS files passed with -e' % (path, pkg, name))
+
+        tag = strip_ns(dtype.tag)
+        if tag == 'ContainerDataType':
+            return 'container', self.container_fields(pkg, name, path)
+        if tag == 'EnumeratedDataType':
+            return 'enum', None
+        if tag == 'IntegerDataType':
+            encoding = dtype.find('{*}IntegerDataEncoding')
+            signed = encoding is not None and encoding.get('encoding', 'unsigned') != 'unsigned'
+            return ('int' if signed else 'uint'), None
+        if tag == 'FloatDataType':
+            encoding = dtype.find('{*}FloatDataEncoding')
+            double = encoding is not None and encoding.get('sizeInBits') == '64'
+            return ('double' if double else 'float'), None
+        if tag == 'StringDataType':
+            return 'string', None
+        if tag == 'ArrayDataType':
+            dims = dtype.findall('{*}DimensionList/{*}Dimension')
+            if len(dims) != 1:
+                sys.exit('%s: only one dimensional arrays are supported' % path)
+            kind, children = self.resolve(pkg, dtype.get('dataTypeRef'), path + '[]')
+            if kind == 'array':
+                sys.exit('%s: arrays of arrays are not supported' % path)
+            return 'array', (Field(None, kind, children), int(dims[0].get('size')))
+
+        sys.exit('%s: unsupported data type %s' % (path, tag))
+
+    def container_fields(self, pkg, name, path=None):
+        path = path or '%s/%s' % (pkg, name)
+        dtype = self.types.get((pkg, name))
+        if dtype is None or strip_ns(dtype.tag) != 'ContainerDataType':
+            sys.exit('%s/%s is not an EDS container' % (pkg, name))
+        if dtype.get('baseType'):
+            sys.exit('%s/%s has a base type, only payload containers are supported' % (pkg, name))
+
+        fields = []
+        for entry in dtype.findall('{*}EntryList/{*}Entry'):
+            entry_path = path + '.' + entry.get('name')
+            kind, info = self.resolve(pkg, entry.get('type'), entry_path)
+            if kind == 'array':
+                fields.append(Field(entry.get('name'), kind, elem=info[0], dim=info[1]))
+            else:
+                fields.append(Field(entry.get('name'), kind, children=info))
+        return fields
+
+
+def strip_ns(tag):
+    return tag.split('}', 1)[-1]
+
+
+def c_str(text):
+    return '"' + text.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+class Writer:
+    """Emit the straight-line serializer statements for a container."""
+
+    SCALAR_FMT = {'uint': '%llu', 'enum': '%lld', 'int': '%lld'}
+    SCALAR_CAST = {'uint': '(unsigned long long)', 'enum': '(long long)', 'int': '(long long)'}
+
+    def __init__(self, indent):
+        self.indent = indent
+        self.lines = []
+        self.fmt = ''
+        self.args = []
+        self.loop = 0
+
+    def text(self, text):
+        self.fmt += text.replace('%', '%%')
+
+    def flush(self):
+        if self.fmt:
+            args = ''.join(', ' + a for a in self.args)
+            self.lines.append('%sTOPIC_CONV_Append(&Writer, %s%s);' % (self.indent, c_str(self.fmt), args))
+        self.fmt = ''
+        self.args = []
+
+    def stmt(self, stmt):
+        self.flush()
+        self.lines.append(self.indent + stmt)
+
+    def value(self, field, expr):
+        if field.kind in self.SCALAR_FMT:
+            self.fmt += self.SCALAR_FMT[field.kind]
+            self.args.append(self.SCALAR_CAST[field.kind] + expr)
+        elif field.kind in ('float', 'double'):
+            self.stmt('TOPIC_CONV_PutDouble(&Writer, %s, %d);' % (expr, 9 if field.kind == 'float' else 17))
+        elif field.kind == 'string':
+            self.stmt('TOPIC_CONV_PutString(&Writer, %s, sizeof(%s));' % (expr, expr))
+        elif field.kind == 'container':
+            self.container(field.children, expr + '.')
+        elif field.kind == 'array':
+            idx = 'i%d' % self.loop
+            self.text('[')
+            self.stmt('for (uint32 %s=0; %s < %d; %s++)' % (idx, idx, field.dim, idx))
+            self.stmt('{')
+            self.loop += 1
+            self.indent += '   '
+            self.stmt('if (%s > 0) TOPIC_CONV_Append(&Writer, ",");' % idx)
+            self.value(field.elem, '%s[%s]' % (expr, idx))
+            self.flush()
+            self.indent = self.indent[:-3]
+            self.loop -= 1
+            self.stmt('}')
+            self.text(']')
+
+    def container(self, fields, prefix):
+        self.text('{')
+        for i, field in enumerate(fields):
+            self.text('%s"%s":' % (',' if i else '', field.name))
+            self.value(field, prefix + field.name)
+        self.text('}')
+
+
+class Reader:
+    """Emit the deserializer statements for a container."""
+
+    GET_MACRO = {'uint': 'TOPIC_CONV_GET_UINT', 'enum': 'TOPIC_CONV_GET_INT', 'int': 'TOPIC_CONV_GET_INT',
+                 'float': 'TOPIC_CONV_GET_DOUBLE', 'double': 'TOPIC_CONV_GET_DOUBLE'}
+
+    def __init__(self, indent):
+        self.indent = indent
+        self.lines = []
+        self.depth = 0
+        self.max_depth = 0
+        self.loop = 0
+
+    def stmt(self, stmt):
+        self.lines.append(self.indent + stmt)
+
+    def value(self, field, key, expr):
+        reader = '&Reader[%d]' % self.depth
+        if field.kind in self.GET_MACRO:
+            self.stmt('Valid = Valid && %s(%s, %s, %s);' % (self.GET_MACRO[field.kind], reader, key, expr))
+        elif field.kind == 'string':
+            self.stmt('Valid = Valid && TOPIC_CONV_GetString(%s, %s, %s, sizeof(%s));' % (reader, key, expr, expr))
+        elif field.kind == 'container':
+            self.nested('TOPIC_CONV_EnterObj', key, lambda: self.container(field.children, expr + '.'))
+        elif field.kind == 'array':
+            def elements():
+                idx = 'i%d' % self.loop
+                self.stmt('for (uint32 %s=0; Valid && %s < %d; %s++)' % (idx, idx, field.dim, idx))
+                self.stmt('{')
+                self.loop += 1
+                self.indent += '   '
+                self.value(field.elem, 'NULL', '%s[%s]' % (expr, idx))
+                self.indent = self.indent[:-3]
+                self.loop -= 1
+                self.stmt('}')
+            self.nested('TOPIC_CONV_EnterArray', key, elements)
+
+    def nested(self, enter_func, key, body):
+        parent = '&Reader[%d]' % self.depth
+        child = '&Reader[%d]' % (self.depth + 1)
+        self.stmt('Valid = Valid && %s(%s, %s, %s);' % (enter_func, parent, key, child))
+        self.depth += 1
+        self.max_depth = max(self.max_depth, self.depth)
+        body()
+        self.depth -= 1
+
+    def container(self, fields, prefix):
+        for field in fields:
+            self.value(field, c_str(field.name), prefix + field.name)
+
+
+def flat_fields(fields):
+    """Return the fields or None if a container has nested containers or arrays."""
+    if any(field.kind in ('container', 'array') for field in fields):
+        return None
+    return fields
+
+
+def generate(eds_db, specs, bench):
+    convs = []
+    packages = set()
+
+    for spec in specs:
+        topic, _, container = spec.rpartition('=')
+        if '/' not in container:
+            sys.exit('Invalid converter spec %s, expected [TopicLabel=]PKG/Container' % spec)
+        pkg, name = container.split('/', 1)
+        packages.add(pkg)
+        convs.append({'topic': topic, 'pkg': pkg, 'name': name,
+                      'ctype': '%s_%s_t' % (pkg, name),
+                      'func': 'TOPIC_CONV_%s_%s' % (pkg, name),
+                      'fields': eds_db.container_fields(pkg, name)})
+
+    hdr = [FILE_PROLOGUE % 'Declare generated JSON<->SB payload converters',
+           '#ifndef _%s_' % GEN_BASENAME, '#define _%s_' % GEN_BASENAME, '',
+           '#include "topic_conv.h"']
+    hdr += ['#include "%s_eds_typedefs.h"' % pkg.lower() for pkg in sorted(packages)]
+    hdr += ['', '']
+
+    src = [FILE_PROLOGUE % 'Generated JSON<->SB payload converters',
+           '#include <stddef.h>', '#include "%s.h"' % GEN_BASENAME, '', '']
+
+    for conv in convs:
+        hdr += ['size_t %s_ToJson(const %s *Payload, char *JsonBuf, size_t JsonBufSize);' % (conv['func'], conv['ctype']),
+                'bool %s_FromJson(const char *Json, size_t JsonLen, %s *Payload);' % (conv['func'], conv['ctype']), '']
+
+        writer = Writer('   ')
+        writer.container(conv['fields'], 'Payload->')
+        writer.flush()
+        src += ['size_t %s_ToJson(const %s *Payload, char *JsonBuf, size_t JsonBufSize)' % (conv['func'], conv['ctype']),
+                '{', '', '   TOPIC_CONV_Writer_t Writer;', '',
+                '   TOPIC_CONV_WriterInit(&Writer, JsonBuf, JsonBufSize);']
+        src += writer.lines
+        src += ['', '   return TOPIC_CONV_WriterEnd(&Writer);', '', '} /* End %s_ToJson() */' % conv['func'], '', '']
+
+        reader = Reader('   ')
+        reader.container(conv['fields'], 'Payload->')
+        src += ['bool %s_FromJson(const char *Json, size_t JsonLen, %s *Payload)' % (conv['func'], conv['ctype']),
+                '{', '', '   TOPIC_CONV_Reader_t Reader[%d];' % (reader.max_depth + 1), '',
+                '   bool Valid = TOPIC_CONV_ReaderInit(&Reader[0], Json, JsonLen);']
+        src += reader.lines
+        src += ['', '   return Valid;', '', '} /* End %s_FromJson() */' % conv['func'], '', '']
+
+        src += ['static size_t %s_ToJsonObj(const void *Payload, char *JsonBuf, size_t JsonBufSize)' % conv['func'],
+                '{', '   return %s_ToJson((const %s *)Payload, JsonBuf, JsonBufSize);' % (conv['func'], conv['ctype']), '}', '',
+                'static bool %s_FromJsonObj(const char *Json, size_t JsonLen, void *Payload)' % conv['func'],
+                '{', '   return %s_FromJson(Json, JsonLen, (%s *)Payload);' % (conv['func'], conv['ctype']), '}', '', '']
+
+    for conv in convs:
+        if conv['topic']:
+            src.append('static char %s_JsonBuf[JMSG_APP_TOPIC_CONV_JSON_MAX_LEN];' % conv['func'])
+    src += ['', '']
+
+    src += ['const TOPIC_CONV_Conv_t TOPIC_CONV_ConvTbl[] =', '{']
+    for conv in convs:
+        if conv['topic']:
+            topic = 'JMSG_PLATFORM_TopicPlugin_%s' % conv['topic']
+            json_buf = '%s_JsonBuf' % conv['func']
+        else:
+            topic, json_buf = 'TOPIC_CONV_NO_TOPIC', 'NULL'
+        src.append('   { %s, "%s/%s", sizeof(%s), %s_ToJsonObj, %s_FromJsonObj, %s },' %
+                   (topic, conv['pkg'], conv['name'], conv['ctype'], conv['func'], conv['func'], json_buf))
+    src += ['   { TOPIC_CONV_NO_TOPIC, NULL, 0, NULL, NULL, NULL }', '};', '', '']
+
+    if bench:
+        src += ['#ifdef TOPIC_CONV_BENCH', '']
+        bench_tbl = []
+        for conv in convs:
+            flat = flat_fields(conv['fields'])
+            if flat is None:
+                bench_tbl.append('   { "%s/%s", NULL },' % (conv['pkg'], conv['name']))
+                continue
+            src.append('static const TOPIC_CONV_BenchField_t %s_BenchFields[] =' % conv['func'])
+            src.append('{')
+            for field in flat:
+                src.append('   { "%s", TOPIC_CONV_BENCH_%s, offsetof(%s, %s), sizeof(((%s *)0)->%s) },' %
+                           (field.name, field.kind.upper(), conv['ctype'], field.name, conv['ctype'], field.name))
+            src += ['   { NULL, 0, 0, 0 }', '};', '']
+            bench_tbl.append('   { "%s/%s", %s_BenchFields },' % (conv['pkg'], conv['name'], conv['func']))
+        src += ['const TOPIC_CONV_BenchConv_t TOPIC_CONV_BenchTbl[] =', '{'] + bench_tbl
+        src += ['   { NULL, NULL }', '};', '', '#endif /* TOPIC_CONV_BENCH */', '']
+
+    hdr += ['#endif /* _%s_ */' % GEN_BASENAME, '']
+
+    return '\n'.join(hdr), '\n'.join(src)
+
+
+FILE_PROLOGUE = """/*
+** Purpose:
+**   %s
+**
+** Notes:
+**   1. This file is generated by tools/topic_conv_gen.py. Do not edit.
+**
+*/
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate JSON<->SB payload converters from EDS')
+    parser.add_argument('-o', '--out-dir', required=True, help='Directory for the generated source files')
+    parser.add_argument('-e', '--eds', action='append', required=True, help='EDS XML file to load')
+    parser.add_argument('--bench', action='store_true', help='Generate benchmark descriptor tables')
+    parser.add_argument('specs', nargs='+', help='[TopicLabel=]PKG/Container')
+    args = parser.parse_args()
+
+    eds_db = EdsDb()
+    for eds_file in args.eds:
+        eds_db.load(eds_file)
+
+    hdr, src = generate(eds_db, args.specs, args.bench)
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    for ext, text in (('.h', hdr), ('.c', src)):
+        with open(os.path.join(args.out_dir, GEN_BASENAME + ext), 'w') as out:
+            out.write(text)
+
+
+if __name__ == '__main__':
+    main()